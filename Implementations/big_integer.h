@@ -6,6 +6,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "fft.h"
+
 /*
 Supports following functions:
 for both positive and negative numbers:
@@ -14,19 +24,23 @@ for both positive and negative numbers:
     Addition
     Subtraction
     Unary minus
-    Multiplication
+    Multiplication (NTT-based for long numbers)
+    Division (truncating, as for built-in integers) and remainder
+    Comparison
+    Conversion to long long (the value must fit)
+    Polynomial<Int> products by Kronecker substitution (kronecker_multiply)
 positive numbers only:
     Maximum
 */
 ////////////////////
 const int POW10 = 1000 * 1000 * 1000;
 
-void check(bool e) {
+inline void check(bool e) {
     if (!e)
         throw 1;
 }
 
-void skip_sym() {
+inline void skip_sym() {
     int c = cin.peek();
     while (c == ' ' || c == '\r' || c == '\n' || c == '\t') {
         cin.get();
@@ -50,6 +64,13 @@ struct UInt {
             check(digit >= 0 || digit < POW10);
     }
 
+    explicit UInt(unsigned long long value) {
+        do {
+            digits.push_back(value % POW10);
+            value /= POW10;
+        } while (value != 0);
+    }
+
     int size() const {
         return (int)digits.size();
     }
@@ -95,12 +116,12 @@ struct UInt {
             return 0;
     }
 
-    void print() const {
-        cout << digits.back();
+    void print(std::ostream& out = std::cout) const {
+        out << digits.back();
 
         for (int i = digits.size() - 2; i >= 0; i--)
             for (int pow = POW10/10; pow >= 1; pow /= 10)
-                cout << digits[i] / pow % 10;
+                out << digits[i] / pow % 10;
     }
 
     bool isZero() const{
@@ -110,7 +131,7 @@ struct UInt {
 
 const UInt UInt_ZERO = UInt(vector<int> {0});
 
-int compare(const UInt& left, const UInt& right) {
+inline int compare(const UInt& left, const UInt& right) {
     //returns negative num if (left < right), null if (left == right), positive num if(left > right)
     if (left.size() != right.size())
         return left.size() - right.size();
@@ -124,7 +145,7 @@ int compare(const UInt& left, const UInt& right) {
     return 0;
 }
 
-UInt operator + (const UInt& left, const UInt& right) {
+inline UInt operator + (const UInt& left, const UInt& right) {
     vector<int> digits;
     int carry = 0;
     for (int i = 0; i < std::max(left.size(), right.size()) || carry != 0; i++) {
@@ -136,7 +157,7 @@ UInt operator + (const UInt& left, const UInt& right) {
     return UInt(digits);
 }
 
-UInt operator - (const UInt& left, const UInt& right) {
+inline UInt operator - (const UInt& left, const UInt& right) {
     //left > right
     vector<int> digits;
     int carry = 0;
@@ -155,10 +176,40 @@ UInt operator - (const UInt& left, const UInt& right) {
     return UInt(digits);
 }
 
-UInt operator * (const UInt& left, const UInt& right) {
+//numbers with more digits than this are multiplied by the three-prime NTT from fft.h
+const int UINT_NTT_THRESHOLD = 64;
+
+inline UInt multiply_ntt(const UInt& left, const UInt& right) {
+    //every convolution term is below min(size) * POW10^2, which must fit in the three-prime modulus;
+    //the length is not limited: when fft::transform_size(size() + size() - 1) exceeds the longest NTT
+    //of a prime (fft::max_ntt_size), fft::multiply_three_primes sums the products of blocks modulo it
+    check(std::min(left.size(), right.size()) < 70 * 1000 * 1000);
+    std::vector<long long> a(left.digits.begin(), left.digits.end());
+    std::vector<long long> b(right.digits.begin(), right.digits.end());
+    std::vector<unsigned __int128> values = fft::multiply_three_primes(a.data(), a.size(), b.data(), b.size());
+
+    std::vector<int> digits;
+    unsigned __int128 carry = 0;
+    for (size_t i = 0; i < values.size() || carry != 0; i++) {
+        if (i < values.size())
+            carry += values[i];
+        digits.push_back(carry % POW10);
+        carry /= POW10;
+    }
+
+    while ((int) digits.size() > 1 && digits.back() == 0)
+        digits.pop_back();
+
+    return UInt(digits);
+}
+
+inline UInt operator * (const UInt& left, const UInt& right) {
     if (left.isZero() || right.isZero())
         return UInt_ZERO;
 
+    if (std::min(left.size(), right.size()) > UINT_NTT_THRESHOLD)
+        return multiply_ntt(left, right);
+
     vector<int> digits;
     ll carry = 0;
 
@@ -177,7 +228,96 @@ UInt operator * (const UInt& left, const UInt& right) {
     return UInt(digits);
 }
 
-UInt max(const UInt& a, const UInt& b) {
+inline std::pair<UInt, UInt> divide(const UInt& left, const UInt& right) {
+    //returns {left / right, left % right}, right > 0
+    //long division by POW10-based digits (Knuth's algorithm D): both numbers are scaled so that
+    //the top digit of right is at least POW10 / 2, then the quotient digit estimated from the top
+    //two digits of the remainder and the top digit of right is corrected by at most 2
+    check(!right.isZero());
+    if (compare(left, right) < 0)
+        return {UInt_ZERO, left};
+
+    auto trim = [](std::vector<int>& digits) {
+        while ((int) digits.size() > 1 && digits.back() == 0)
+            digits.pop_back();
+    };
+
+    const int n = right.size(), m = left.size() - n;
+    std::vector<int> quotient(m + 1, 0);
+    if (n == 1) {
+        long long rem = 0;
+        for (int i = m; i >= 0; i--) {
+            rem = rem * POW10 + left[i];
+            quotient[i] = rem / right[0];
+            rem %= right[0];
+        }
+        trim(quotient);
+        return {UInt(quotient), UInt((unsigned long long) rem)};
+    }
+
+    const int scale = POW10 / (right[n - 1] + 1);
+    auto scaled = [scale](const UInt& num, int size) {
+        std::vector<int> digits(size, 0);
+        long long carry = 0;
+        for (int i = 0; i < size; i++) {
+            carry += 1LL * num[i] * scale;
+            digits[i] = carry % POW10;
+            carry /= POW10;
+        }
+        return digits;
+    };
+    const std::vector<int> v = scaled(right, n);
+    std::vector<int> u = scaled(left, m + n + 1);
+
+    for (int j = m; j >= 0; j--) {
+        const long long top = 1LL * u[j + n] * POW10 + u[j + n - 1];
+        long long digit = top / v[n - 1], rest = top % v[n - 1];
+        while (digit >= POW10 || digit * v[n - 2] > rest * POW10 + u[j + n - 2]) {
+            digit--;
+            rest += v[n - 1];
+            if (rest >= POW10)
+                break;
+        }
+
+        //u[j..j+n] -= digit * v
+        long long carry = 0, borrow = 0;
+        for (int i = 0; i < n; i++) {
+            carry += digit * v[i];
+            long long cur = u[i + j] - carry % POW10 - borrow;
+            carry /= POW10;
+            borrow = (cur < 0);
+            u[i + j] = cur + (borrow ? POW10 : 0);
+        }
+        long long cur = u[j + n] - carry - borrow;
+        if (cur < 0) {
+            //digit was one too large: add v back, the carry out cancels cur
+            digit--;
+            carry = 0;
+            for (int i = 0; i < n; i++) {
+                carry += u[i + j] + v[i];
+                u[i + j] = carry % POW10;
+                carry /= POW10;
+            }
+            cur += carry;
+        }
+        u[j + n] = cur;
+        quotient[j] = digit;
+    }
+
+    //the remainder is u[0..n-1] / scale
+    std::vector<int> rem(n, 0);
+    long long carry = 0;
+    for (int i = n - 1; i >= 0; i--) {
+        carry = carry * POW10 + u[i];
+        rem[i] = carry / scale;
+        carry %= scale;
+    }
+    trim(quotient);
+    trim(rem);
+    return {UInt(quotient), UInt(rem)};
+}
+
+inline UInt max(const UInt& a, const UInt& b) {
     //returns maximum UInt of two given UInt nums
     if (compare(a, b) > 0)
         return a;
@@ -185,14 +325,14 @@ UInt max(const UInt& a, const UInt& b) {
         return b;
 }
 
-UInt min(const UInt& a, const UInt& b) {
+inline UInt min(const UInt& a, const UInt& b) {
     if (compare(a, b) > 0)
         return b;
     else
         return a;
 }
 
-UInt max(const std::initializer_list<UInt> list) {
+inline UInt max(const std::initializer_list<UInt> list) {
     //returns maximum UInt of given UInt list
     UInt cur_max = *list.begin();
 
@@ -235,24 +375,28 @@ struct Int {
         return Int(modulus, sign);
     }
 
-    void print() const {
+    Int(long long value = 0) : modulus(UInt(value < 0 ? 0ULL - (unsigned long long) value : value)),
+                               sign(value < 0 ? -1 : (value > 0 ? 1 : 0)) {}
+
+    void print(std::ostream& out = std::cout) const {
         if (sign == -1)
-            cout << '-';
+            out << '-';
 
-        modulus.print();
+        modulus.print(out);
     }
 
     bool isZero() const {
         return sign == 0;
     }
 
+    explicit operator long long() const;
 };
 
-Int operator - (const Int& num)  {
+inline Int operator - (const Int& num)  {
     return Int(num.modulus, -num.sign);
 }
 
-Int operator - (const Int& left, const Int& right) {
+inline Int operator - (const Int& left, const Int& right) {
     if (right.isZero())
         return left;
     if (left.isZero())
@@ -274,7 +418,7 @@ Int operator - (const Int& left, const Int& right) {
     }
 }
 
-Int operator + (const Int& left, const Int& right) {
+inline Int operator + (const Int& left, const Int& right) {
     if (left.isZero())
         return right;
     if (right.isZero())
@@ -292,7 +436,7 @@ Int operator + (const Int& left, const Int& right) {
         return Int(left.modulus - right.modulus, left.sign);
 }
 
-Int operator * (const Int& left, const Int& right) {
+inline Int operator * (const Int& left, const Int& right) {
     if (left.sign == 0 || right.sign == 0)
         return Int(UInt_ZERO, 0);
 
@@ -301,3 +445,143 @@ Int operator * (const Int& left, const Int& right) {
     else
         return Int(left.modulus * right.modulus, -1);
 }
+
+inline int compare(const Int& left, const Int& right) {
+    //returns negative num if (left < right), null if (left == right), positive num if(left > right)
+    if (left.sign != right.sign)
+        return left.sign - right.sign;
+
+    int cmp = compare(left.modulus, right.modulus);
+    return (left.sign < 0 ? -cmp : cmp);
+}
+
+inline bool operator == (const Int& left, const Int& right) {
+    return compare(left, right) == 0;
+}
+
+inline bool operator != (const Int& left, const Int& right) {
+    return compare(left, right) != 0;
+}
+
+inline bool operator < (const Int& left, const Int& right) {
+    return compare(left, right) < 0;
+}
+
+inline bool operator > (const Int& left, const Int& right) {
+    return compare(left, right) > 0;
+}
+
+inline Int& operator += (Int& left, const Int& right) {
+    return left = left + right;
+}
+
+inline Int& operator -= (Int& left, const Int& right) {
+    return left = left - right;
+}
+
+inline Int& operator *= (Int& left, const Int& right) {
+    return left = left * right;
+}
+
+inline Int operator / (const Int& left, const Int& right) {
+    //rounds towards zero
+    UInt quotient = divide(left.modulus, right.modulus).first;
+    return Int(quotient, quotient.isZero() ? 0 : left.sign * right.sign);
+}
+
+inline Int operator % (const Int& left, const Int& right) {
+    //has the sign of left, left == left / right * right + left % right
+    UInt rem = divide(left.modulus, right.modulus).second;
+    return Int(rem, rem.isZero() ? 0 : left.sign);
+}
+
+inline Int& operator /= (Int& left, const Int& right) {
+    return left = left / right;
+}
+
+inline Int& operator %= (Int& left, const Int& right) {
+    return left = left % right;
+}
+
+inline Int::operator long long() const {
+    check(compare(*this, Int(std::numeric_limits<long long>::min())) >= 0 &&
+          compare(*this, Int(std::numeric_limits<long long>::max())) <= 0);
+    unsigned long long value = 0;
+    for (int i = modulus.size() - 1; i >= 0; i--)
+        value = value * POW10 + modulus[i];
+    return (long long) (sign < 0 ? 0ULL - value : value);
+}
+
+inline Int abs(const Int& num) {
+    return Int(num.modulus, num.sign * num.sign);
+}
+
+inline std::ostream& operator << (std::ostream& out, const Int& num) {
+    num.print(out);
+    return out;
+}
+
+//Kronecker substitution: the coefficients of both polynomials are written as POW10-based digits
+//of one number each, in slots of SLOT digits (a negative coefficient is subtracted in its slot),
+//so that a single big multiplication gives every coefficient of the product in its own slot.
+//SLOT is wide enough for |coefficient| < POW10^SLOT / 2, hence the slots are read in balanced form.
+//Polynomial<Int> multiplication (polynomial.h) calls it for long operands.
+inline std::vector<Int> kronecker_multiply(const Int* lhs, size_t lsize, const Int* rhs, size_t rsize) {
+    int lwidth = 1, rwidth = 1;
+    for (size_t i = 0; i < lsize; i++)
+        lwidth = std::max(lwidth, lhs[i].modulus.size());
+    for (size_t i = 0; i < rsize; i++)
+        rwidth = std::max(rwidth, rhs[i].modulus.size());
+    //|product coefficient| < min(lsize, rsize) * POW10^(lwidth + rwidth), the extra digits hold 2 * min(lsize, rsize)
+    const int SLOT = lwidth + rwidth + (2 * std::min(lsize, rsize) < (size_t) POW10 ? 1 : 2);
+
+    auto pack = [SLOT](const Int* coeffs, size_t size) {
+        std::vector<int> positive(size * SLOT, 0), negative(size * SLOT, 0);
+        for (size_t i = 0; i < size; i++) {
+            std::vector<int>& digits = (coeffs[i].sign < 0 ? negative : positive);
+            for (int j = 0; j < coeffs[i].modulus.size(); j++)
+                digits[i * SLOT + j] = coeffs[i].modulus[j];
+        }
+        for (std::vector<int>* digits : {&positive, &negative})
+            while ((int) digits->size() > 1 && digits->back() == 0)
+                digits->pop_back();
+        UInt positive_part(positive), negative_part(negative);
+        return Int(positive_part, positive_part.isZero() ? 0 : 1) -
+               Int(negative_part, negative_part.isZero() ? 0 : 1);
+    };
+    const Int product = pack(lhs, lsize) * pack(rhs, rsize);
+
+    //slot by slot from the lowest: a slot value v >= POW10^SLOT / 2 stands for v - POW10^SLOT,
+    //which carries 1 into the next slot
+    std::vector<Int> res(lsize + rsize - 1);
+    int carry = 0;
+    for (size_t i = 0; i < res.size(); i++) {
+        std::vector<int> slot(SLOT);
+        for (int j = 0; j < SLOT; j++)
+            slot[j] = product.modulus[i * SLOT + j];
+        for (int j = 0; j < SLOT && carry != 0; j++) {
+            slot[j] += carry;
+            carry = slot[j] / POW10;
+            slot[j] %= POW10;
+        }
+        int sign = 1;
+        if (carry == 0 && slot.back() >= POW10 / 2) {
+            //POW10^SLOT - v, digit by digit
+            for (int j = 0; j < SLOT; j++)
+                slot[j] = POW10 - 1 - slot[j];
+            for (int j = 0, add = 1; j < SLOT && add != 0; j++) {
+                slot[j] += add;
+                add = slot[j] / POW10;
+                slot[j] %= POW10;
+            }
+            sign = -1;
+            carry = 1;
+        }
+
+        while ((int) slot.size() > 1 && slot.back() == 0)
+            slot.pop_back();
+        UInt modulus(slot);
+        res[i] = (modulus.isZero() ? Int(0) : Int(modulus, sign * product.sign));
+    }
+    return res;
+}
@@ -0,0 +1,436 @@
+#pragma once
+
+//
+// Created on 19/10/2026
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "modint.h"
+
+// Iterative radix-2 FFT, number-theoretic transform and convolutions built on them
+namespace fft {
+
+// real type the transforms of ValueType are computed in:
+// float coefficients are transformed in double to keep the precision
+template <typename ValueType>
+struct real_type {
+    using type = typename std::conditional<std::is_same<ValueType, long double>::value,
+                                           long double, double>::type;
+};
+
+template <typename Real>
+struct real_type<std::complex<Real>> : real_type<Real> {};
+
+inline size_t transform_size(size_t size);
+
+// table of twiddle factors: roots[k + j] = exp(i * pi * j / k) for every power of two k < size;
+// a thread_local table is computed once per thread (in long double), extended when a longer
+// transform is requested, and its first size entries are copied out to the caller
+template <typename Real>
+std::vector<std::complex<Real>> twiddles(size_t size);
+
+// in-place transform, size of a must be a power of two
+template <typename Real>
+void transform(std::vector<std::complex<Real>>& a, bool invert);
+
+// coefficients of the product of two real polynomials
+template <typename ValueType>
+std::vector<ValueType> multiply_real(const ValueType* lhs, size_t lsize,
+                                     const ValueType* rhs, size_t rsize);
+
+// coefficients of the product of two complex polynomials
+template <typename Real>
+std::vector<std::complex<Real>> multiply_complex(const std::complex<Real>* lhs, size_t lsize,
+                                                 const std::complex<Real>* rhs, size_t rsize);
+
+// smallest generator of the multiplicative group modulo the prime MOD
+template <uint32_t MOD>
+uint32_t primitive_root();
+
+// the longest NTT modulo MOD: the largest power of two dividing MOD - 1
+template <uint32_t MOD>
+size_t max_ntt_size();
+
+// roots[k + j] = w^j, where w is a primitive (2k)-th root of unity modulo MOD, for every power of two k < size;
+// copied out of a thread_local table like twiddles
+template <uint32_t MOD>
+std::vector<ModInt<MOD>> ntt_twiddles(size_t size);
+
+// in-place number-theoretic transform, size of a must be a power of two
+// not exceeding max_ntt_size<MOD>()
+template <uint32_t MOD>
+void ntt(std::vector<ModInt<MOD>>& a, bool invert);
+
+// coefficients of the product over ModInt<MOD> with an NTT-friendly prime MOD,
+// the product must fit one transform: transform_size(lsize + rsize - 1) <= max_ntt_size<MOD>()
+template <uint32_t MOD>
+std::vector<ModInt<MOD>> multiply_ntt(const ModInt<MOD>* lhs, size_t lsize,
+                                      const ModInt<MOD>* rhs, size_t rsize);
+
+// lhs * rhs as the sum of the products of blocks of at most block coefficients of each factor,
+// every one computed by multiply(lhs, lsize, rhs, rsize); keeps longer products within a transform
+template <typename ValueType, typename Multiply>
+std::vector<ValueType> multiply_blocks(const ValueType* lhs, size_t lsize,
+                                       const ValueType* rhs, size_t rsize, size_t block, Multiply multiply);
+
+// primes p = c * 2^k + 1 for the three-prime convolution,
+// their product is about 7.8 * 10^25 (more than 2^86)
+const uint32_t CRT_MOD1 = 998244353;   // 119 * 2^23 + 1
+const uint32_t CRT_MOD2 = 167772161;   // 5 * 2^25 + 1
+const uint32_t CRT_MOD3 = 469762049;   // 7 * 2^26 + 1
+
+// exact convolution of integer sequences computed modulo the three primes above
+// and recombined by CRT; the result is in [0, CRT_MOD1 * CRT_MOD2 * CRT_MOD3).
+// products longer than one transform are summed from blocks modulo every prime
+inline std::vector<unsigned __int128> multiply_three_primes(const long long* lhs, size_t lsize,
+                                                            const long long* rhs, size_t rsize);
+
+// coefficients of the product of integer polynomials, exact while
+// every coefficient of the product is less than 2^85 by absolute value
+inline std::vector<long long> multiply_exact(const long long* lhs, size_t lsize,
+                                             const long long* rhs, size_t rsize);
+
+// coefficients of the product over ModInt<MOD> for an arbitrary MOD < 2^31
+template <uint32_t MOD>
+std::vector<ModInt<MOD>> multiply_arbitrary_mod(const ModInt<MOD>* lhs, size_t lsize,
+                                                const ModInt<MOD>* rhs, size_t rsize);
+
+//
+// implementation:
+//
+
+inline size_t transform_size(size_t size) {
+    size_t res = 1;
+    while (res < size) {
+        res <<= 1;
+    }
+    return res;
+}
+
+template <typename Real>
+std::vector<std::complex<Real>> twiddles(size_t size) {
+    thread_local std::vector<std::complex<Real>> roots(2, std::complex<Real>(1));
+    static const long double PI = std::acos(-1.0L);
+
+    for (size_t k = roots.size(); k < size; k *= 2) {
+        roots.resize(2 * k);
+        for (size_t j = 0; j < k; ++j) {
+            long double angle = PI * j / k;
+            roots[k + j] = std::complex<Real>(std::cos(angle), std::sin(angle));
+        }
+    }
+    return std::vector<std::complex<Real>>(roots.begin(), roots.begin() + std::min(size, roots.size()));
+}
+
+template <typename Real>
+void transform(std::vector<std::complex<Real>>& a, bool invert) {
+    const size_t n = a.size();
+    if (n <= 1) {
+        return;
+    }
+    const std::vector<std::complex<Real>> roots = twiddles<Real>(n);
+
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(a[i], a[j]);
+        }
+    }
+
+    for (size_t k = 1; k < n; k *= 2) {
+        for (size_t i = 0; i < n; i += 2 * k) {
+            for (size_t j = 0; j < k; ++j) {
+                // complex multiplication written out: std::complex operator* checks for NaNs
+                const std::complex<Real>& root = roots[k + j];
+                const std::complex<Real>& x = a[i + j + k];
+                std::complex<Real> z(root.real() * x.real() - root.imag() * x.imag(),
+                                     root.real() * x.imag() + root.imag() * x.real());
+                a[i + j + k] = a[i + j] - z;
+                a[i + j] += z;
+            }
+        }
+    }
+
+    if (invert) {
+        std::reverse(a.begin() + 1, a.end());
+        for (auto& value : a) {
+            value /= static_cast<Real>(n);
+        }
+    }
+}
+
+template <typename ValueType>
+std::vector<ValueType> multiply_real(const ValueType* lhs, size_t lsize,
+                                     const ValueType* rhs, size_t rsize) {
+    using Real = typename real_type<ValueType>::type;
+    const size_t res_size = lsize + rsize - 1;
+    const size_t n = transform_size(res_size);
+
+    // both polynomials are packed into one complex one: lhs + i * rhs,
+    // then (lhs + i * rhs)^2 - conj(lhs - i * rhs)^2 = 4 * i * lhs * rhs,
+    // so the product takes only two transforms instead of three
+    std::vector<std::complex<Real>> in(n), out(n);
+    for (size_t i = 0; i < lsize; ++i) {
+        in[i].real(lhs[i]);
+    }
+    for (size_t i = 0; i < rsize; ++i) {
+        in[i].imag(rhs[i]);
+    }
+    transform(in, false);
+    for (auto& value : in) {
+        value *= value;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = in[(n - i) & (n - 1)] - std::conj(in[i]);
+    }
+    // the forward transform of a transformed vector gives its inverse with negated indices,
+    // the index negation is already folded into out
+    transform(out, false);
+
+    std::vector<ValueType> res(res_size);
+    for (size_t i = 0; i < res_size; ++i) {
+        res[i] = static_cast<ValueType>(out[i].imag() / (4 * n));
+    }
+    return res;
+}
+
+template <typename Real>
+std::vector<std::complex<Real>> multiply_complex(const std::complex<Real>* lhs, size_t lsize,
+                                                 const std::complex<Real>* rhs, size_t rsize) {
+    using TransformReal = typename real_type<Real>::type;
+    const size_t res_size = lsize + rsize - 1;
+    const size_t n = transform_size(res_size);
+
+    std::vector<std::complex<TransformReal>> lvec(lhs, lhs + lsize), rvec(rhs, rhs + rsize);
+    lvec.resize(n);
+    rvec.resize(n);
+    transform(lvec, false);
+    transform(rvec, false);
+    for (size_t i = 0; i < n; ++i) {
+        lvec[i] *= rvec[i];
+    }
+    transform(lvec, true);
+
+    return std::vector<std::complex<Real>>(lvec.begin(), lvec.begin() + res_size);
+}
+
+template <uint32_t MOD>
+uint32_t primitive_root() {
+    // initialized once, safely for concurrent first calls
+    static const uint32_t ROOT = [] {
+        std::vector<uint32_t> prime_divisors;
+        uint32_t rest = MOD - 1;
+        for (uint32_t div = 2; div * div <= rest; ++div) {
+            if (rest % div == 0) {
+                prime_divisors.push_back(div);
+                while (rest % div == 0) {
+                    rest /= div;
+                }
+            }
+        }
+        if (rest > 1) {
+            prime_divisors.push_back(rest);
+        }
+
+        for (uint32_t candidate = 2; ; ++candidate) {
+            bool is_generator = true;
+            for (uint32_t div : prime_divisors) {
+                if (ModInt<MOD>(candidate).pow((MOD - 1) / div) == ModInt<MOD>(1)) {
+                    is_generator = false;
+                    break;
+                }
+            }
+            if (is_generator) {
+                return candidate;
+            }
+        }
+    }();
+    return ROOT;
+}
+
+template <uint32_t MOD>
+size_t max_ntt_size() {
+    return static_cast<size_t>((MOD - 1) & -(MOD - 1));
+}
+
+template <uint32_t MOD>
+std::vector<ModInt<MOD>> ntt_twiddles(size_t size) {
+    thread_local std::vector<ModInt<MOD>> roots(2, ModInt<MOD>(1));
+
+    for (size_t k = roots.size(); k < size; k *= 2) {
+        roots.resize(2 * k);
+        ModInt<MOD> step = ModInt<MOD>(primitive_root<MOD>()).pow((MOD - 1) / (2 * k));
+        for (size_t j = k; j < 2 * k; j += 2) {
+            roots[j] = roots[j / 2];
+            roots[j + 1] = roots[j / 2] * step;
+        }
+    }
+    return std::vector<ModInt<MOD>>(roots.begin(), roots.begin() + std::min(size, roots.size()));
+}
+
+template <uint32_t MOD>
+void ntt(std::vector<ModInt<MOD>>& a, bool invert) {
+    const size_t n = a.size();
+    if (n <= 1) {
+        return;
+    }
+    // longer transforms have no root of unity of their order modulo MOD
+    assert(n <= max_ntt_size<MOD>());
+    const std::vector<ModInt<MOD>> roots = ntt_twiddles<MOD>(n);
+
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(a[i], a[j]);
+        }
+    }
+
+    for (size_t k = 1; k < n; k *= 2) {
+        for (size_t i = 0; i < n; i += 2 * k) {
+            for (size_t j = 0; j < k; ++j) {
+                ModInt<MOD> z = roots[k + j] * a[i + j + k];
+                a[i + j + k] = a[i + j] - z;
+                a[i + j] += z;
+            }
+        }
+    }
+
+    if (invert) {
+        std::reverse(a.begin() + 1, a.end());
+        ModInt<MOD> inv_n = ModInt<MOD>(static_cast<long long>(n)).inverse();
+        for (auto& value : a) {
+            value *= inv_n;
+        }
+    }
+}
+
+template <uint32_t MOD>
+std::vector<ModInt<MOD>> multiply_ntt(const ModInt<MOD>* lhs, size_t lsize,
+                                      const ModInt<MOD>* rhs, size_t rsize) {
+    const size_t res_size = lsize + rsize - 1;
+    const size_t n = transform_size(res_size);
+    assert(n <= max_ntt_size<MOD>());
+
+    std::vector<ModInt<MOD>> lvec(lhs, lhs + lsize), rvec(rhs, rhs + rsize);
+    lvec.resize(n);
+    rvec.resize(n);
+    ntt(lvec, false);
+    ntt(rvec, false);
+    for (size_t i = 0; i < n; ++i) {
+        lvec[i] *= rvec[i];
+    }
+    ntt(lvec, true);
+
+    lvec.resize(res_size);
+    return lvec;
+}
+
+template <typename ValueType, typename Multiply>
+std::vector<ValueType> multiply_blocks(const ValueType* lhs, size_t lsize,
+                                       const ValueType* rhs, size_t rsize, size_t block, Multiply multiply) {
+    if (lsize <= block && rsize <= block) {
+        return multiply(lhs, lsize, rhs, rsize);
+    }
+    std::vector<ValueType> res(lsize + rsize - 1, ValueType(0));
+    for (size_t lfirst = 0; lfirst < lsize; lfirst += block) {
+        for (size_t rfirst = 0; rfirst < rsize; rfirst += block) {
+            std::vector<ValueType> part = multiply(lhs + lfirst, std::min(block, lsize - lfirst),
+                                                   rhs + rfirst, std::min(block, rsize - rfirst));
+            for (size_t i = 0; i < part.size(); ++i) {
+                res[lfirst + rfirst + i] += part[i];
+            }
+        }
+    }
+    return res;
+}
+
+template <uint32_t MOD>
+std::vector<ModInt<MOD>> multiply_residues(const long long* lhs, size_t lsize,
+                                           const long long* rhs, size_t rsize) {
+    std::vector<ModInt<MOD>> lvec(lhs, lhs + lsize), rvec(rhs, rhs + rsize);
+    // blocks of half the longest transform, their products fit it
+    return multiply_blocks(lvec.data(), lsize, rvec.data(), rsize, max_ntt_size<MOD>() / 2,
+                           multiply_ntt<MOD>);
+}
+
+inline std::vector<unsigned __int128> multiply_three_primes(const long long* lhs, size_t lsize,
+                                                            const long long* rhs, size_t rsize) {
+    auto res1 = multiply_residues<CRT_MOD1>(lhs, lsize, rhs, rsize);
+    auto res2 = multiply_residues<CRT_MOD2>(lhs, lsize, rhs, rsize);
+    auto res3 = multiply_residues<CRT_MOD3>(lhs, lsize, rhs, rsize);
+
+    // Garner's algorithm: x = r1 + m1 * (t2 + m2 * t3)
+    const ModInt<CRT_MOD2> INV1_MOD2 = ModInt<CRT_MOD2>(CRT_MOD1).inverse();
+    const ModInt<CRT_MOD3> INV12_MOD3 =
+            (ModInt<CRT_MOD3>(CRT_MOD1) * ModInt<CRT_MOD3>(CRT_MOD2)).inverse();
+
+    std::vector<unsigned __int128> res(res1.size());
+    for (size_t i = 0; i < res.size(); ++i) {
+        uint32_t r1 = res1[i].value();
+        ModInt<CRT_MOD2> t2 = (res2[i] - ModInt<CRT_MOD2>(r1)) * INV1_MOD2;
+        uint64_t x12 = r1 + static_cast<uint64_t>(CRT_MOD1) * t2.value();
+        ModInt<CRT_MOD3> t3 = (res3[i] - ModInt<CRT_MOD3>(static_cast<long long>(x12))) * INV12_MOD3;
+        res[i] = x12 + static_cast<unsigned __int128>(CRT_MOD1) * CRT_MOD2 * t3.value();
+    }
+    return res;
+}
+
+inline std::vector<long long> multiply_exact(const long long* lhs, size_t lsize,
+                                             const long long* rhs, size_t rsize) {
+    const unsigned __int128 PRODUCT = static_cast<unsigned __int128>(CRT_MOD1) * CRT_MOD2 * CRT_MOD3;
+
+    auto values = multiply_three_primes(lhs, lsize, rhs, rsize);
+    std::vector<long long> res(values.size());
+    for (size_t i = 0; i < res.size(); ++i) {
+        if (values[i] > PRODUCT / 2) {  // negative coefficient
+            res[i] = -static_cast<long long>(PRODUCT - values[i]);
+        } else {
+            res[i] = static_cast<long long>(values[i]);
+        }
+    }
+    return res;
+}
+
+template <uint32_t MOD>
+std::vector<ModInt<MOD>> multiply_arbitrary_mod(const ModInt<MOD>* lhs, size_t lsize,
+                                                const ModInt<MOD>* rhs, size_t rsize) {
+    std::vector<long long> lvec(lsize), rvec(rsize);
+    for (size_t i = 0; i < lsize; ++i) {
+        lvec[i] = lhs[i].value();
+    }
+    for (size_t i = 0; i < rsize; ++i) {
+        rvec[i] = rhs[i].value();
+    }
+
+    // every coefficient of a product of blocks of 2^22 residues is below 2^22 * MOD^2 < 2^84,
+    // within the three-prime modulus; the blocks are summed modulo MOD
+    auto multiply_residue_block = [&lvec, &rvec, lhs, rhs](const ModInt<MOD>* lblock, size_t lblock_size,
+                                                           const ModInt<MOD>* rblock, size_t rblock_size) {
+        auto values = multiply_three_primes(lvec.data() + (lblock - lhs), lblock_size,
+                                            rvec.data() + (rblock - rhs), rblock_size);
+        std::vector<ModInt<MOD>> res(values.size());
+        for (size_t i = 0; i < res.size(); ++i) {
+            res[i] = ModInt<MOD>(static_cast<long long>(values[i] % MOD));
+        }
+        return res;
+    };
+    return multiply_blocks(lhs, lsize, rhs, rsize, max_ntt_size<CRT_MOD1>() / 2, multiply_residue_block);
+}
+
+}  // namespace fft
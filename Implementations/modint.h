@@ -0,0 +1,159 @@
+#pragma once
+
+//
+// Created on 19/10/2026
+//
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+// Residue modulo MOD, usable as ValueType of Polynomial
+// MOD must be less than 2^31 so that the sum of two residues fits in uint32_t;
+// division requires MOD to be prime
+template <uint32_t MOD>
+class ModInt {
+private:
+    uint32_t val;
+
+public:
+    static constexpr uint32_t modulus = MOD;
+
+    ModInt(long long num = 0): val(static_cast<uint32_t>((num % static_cast<long long>(MOD) + MOD) % MOD)) {}
+
+    uint32_t value() const {
+        return val;
+    }
+
+    ModInt pow(unsigned long long exp) const {
+        ModInt res(1), base(*this);
+        for (; exp; exp >>= 1) {
+            if (exp & 1) {
+                res *= base;
+            }
+            base *= base;
+        }
+        return res;
+    }
+
+    // Fermat's little theorem, MOD must be prime
+    ModInt inverse() const {
+        return pow(MOD - 2);
+    }
+
+    ModInt operator+() const {
+        return *this;
+    }
+
+    ModInt operator-() const {
+        return ModInt(val == 0 ? 0 : MOD - val);
+    }
+
+    ModInt& operator+=(const ModInt& other) {
+        val += other.val;
+        if (val >= MOD) {
+            val -= MOD;
+        }
+        return *this;
+    }
+
+    ModInt& operator-=(const ModInt& other) {
+        val += MOD - other.val;
+        if (val >= MOD) {
+            val -= MOD;
+        }
+        return *this;
+    }
+
+    ModInt& operator*=(const ModInt& other) {
+        val = static_cast<uint32_t>(static_cast<uint64_t>(val) * other.val % MOD);
+        return *this;
+    }
+
+    ModInt& operator/=(const ModInt& other) {
+        return (*this *= other.inverse());
+    }
+
+    friend ModInt operator+(ModInt lhs, const ModInt& rhs) {
+        return (lhs += rhs);
+    }
+
+    friend ModInt operator-(ModInt lhs, const ModInt& rhs) {
+        return (lhs -= rhs);
+    }
+
+    friend ModInt operator*(ModInt lhs, const ModInt& rhs) {
+        return (lhs *= rhs);
+    }
+
+    friend ModInt operator/(ModInt lhs, const ModInt& rhs) {
+        return (lhs /= rhs);
+    }
+
+    friend bool operator==(const ModInt& lhs, const ModInt& rhs) {
+        return lhs.val == rhs.val;
+    }
+
+    friend bool operator!=(const ModInt& lhs, const ModInt& rhs) {
+        return lhs.val != rhs.val;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const ModInt& num) {
+        return out << num.val;
+    }
+
+    friend std::istream& operator>>(std::istream& in, ModInt& num) {
+        long long value;
+        in >> value;
+        num = ModInt(value);
+        return in;
+    }
+};
+
+// residues have no sign: Polynomial prints every coefficient as it is
+template <uint32_t MOD>
+ModInt<MOD> abs(const ModInt<MOD>& num) {
+    return num;
+}
+
+// a square root modulo the prime MOD by Tonelli-Shanks,
+// throws std::domain_error if num is not a quadratic residue
+template <uint32_t MOD>
+ModInt<MOD> sqrt(const ModInt<MOD>& num) {
+    if (num == ModInt<MOD>(0) || MOD == 2) {
+        return num;
+    }
+    if (num.pow((MOD - 1) / 2) != ModInt<MOD>(1)) {
+        throw std::domain_error("ModInt: not a quadratic residue");
+    }
+
+    // MOD - 1 = odd * 2^shift
+    uint32_t odd = MOD - 1, shift = 0;
+    while (odd % 2 == 0) {
+        odd /= 2;
+        ++shift;
+    }
+    ModInt<MOD> non_residue(2);
+    while (non_residue.pow((MOD - 1) / 2) == ModInt<MOD>(1)) {
+        non_residue += ModInt<MOD>(1);
+    }
+
+    ModInt<MOD> root = num.pow((odd + 1) / 2), error = num.pow(odd);
+    ModInt<MOD> fix = non_residue.pow(odd);
+    while (error != ModInt<MOD>(1)) {
+        // the least order 2^i of error, then error * fix^(2^(shift - i)) has a lower order
+        uint32_t order = 0;
+        for (ModInt<MOD> cur = error; cur != ModInt<MOD>(1); cur *= cur) {
+            ++order;
+        }
+        ModInt<MOD> step = fix;
+        for (uint32_t i = 0; i + order + 1 < shift; ++i) {
+            step *= step;
+        }
+        root *= step;
+        fix = step * step;
+        error *= fix;
+        shift = order;
+    }
+    return root;
+}
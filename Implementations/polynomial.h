@@ -5,9 +5,24 @@
 //
 
 #include <algorithm>
+#include <complex>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "fft.h"
+#include "modint.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
 template <typename ValueType>
 class Polynomial {
 private:
@@ -18,17 +33,28 @@ private:
 
 public:
     explicit Polynomial(const std::vector<ValueType>&);
+    explicit Polynomial(std::vector<ValueType>&&);
     explicit Polynomial(const ValueType& = ValueType());
     template <typename Iter>
     Polynomial(Iter first, Iter last);
 
     int Degree() const;
 
+    // preallocates room for coefficients of degrees up to degree
+    void reserve(size_t degree);
+
     const ValueType& operator[](size_t index) const;
     // ValueType& operator[](size_t index);
 
     ValueType operator()(const ValueType&) const;
 
+    // values at all the points: remainder-tree descent over a subproduct tree,
+    // O(M(n) log n) instead of O(n^2) for n points and degree n
+    std::vector<ValueType> evaluate(const std::vector<ValueType>& points) const;
+    // out[i] = value at points[i] for i in [0, count) by Horner's rule over blocks of points,
+    // vectorized for double and float
+    void evaluate(const ValueType* points, size_t count, ValueType* out) const;
+
     typename std::vector<ValueType>::const_iterator begin() const;
     typename std::vector<ValueType>::const_iterator end() const;
 
@@ -41,7 +67,22 @@ public:
     Polynomial<ValueType>& operator*=(const Polynomial<ValueType>&);
     Polynomial<ValueType>& operator*=(const ValueType&);
 
-    Polynomial<ValueType> operator-() const;
+    Polynomial<ValueType> operator-() const&;
+    Polynomial<ValueType> operator-() &&;
+
+    // truncated power series: the results are taken mod x^n,
+    // for field coefficient types; violated preconditions throw std::domain_error
+
+    // 1 / f, f[0] != 0
+    Polynomial<ValueType> inverse(size_t n) const;
+    // log(f), f[0] == 1
+    Polynomial<ValueType> log(size_t n) const;
+    // exp(f), f[0] == 0
+    Polynomial<ValueType> exp(size_t n) const;
+    // g with g^2 = f, the lowest nonzero term of f must be a square
+    Polynomial<ValueType> sqrt(size_t n) const;
+    // f^k
+    Polynomial<ValueType> pow(unsigned long long k, size_t n) const;
 };
 
 template<typename ValueType>
@@ -54,6 +95,22 @@ Polynomial<ValueType> operator+(const Polynomial<ValueType>& lhs, const ValueTyp
 template<typename ValueType>
 Polynomial<ValueType> operator+(const ValueType& lhs, const Polynomial<ValueType>& rhs);
 
+// the overloads taking an rvalue polynomial reuse its buffer for the result
+template<typename ValueType>
+Polynomial<ValueType> operator+(Polynomial<ValueType>&& lhs, const Polynomial<ValueType>& rhs);
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(const Polynomial<ValueType>& lhs, Polynomial<ValueType>&& rhs);
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(Polynomial<ValueType>&& lhs, Polynomial<ValueType>&& rhs);
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(Polynomial<ValueType>&& lhs, const ValueType& rhs);
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(const ValueType& lhs, Polynomial<ValueType>&& rhs);
+
 template<typename ValueType>
 Polynomial<ValueType> operator-(const Polynomial<ValueType>& lhs,
                                 const Polynomial<ValueType>& rhs);
@@ -64,6 +121,21 @@ Polynomial<ValueType> operator-(const Polynomial<ValueType>& lhs, const ValueTyp
 template<typename ValueType>
 Polynomial<ValueType> operator-(const ValueType& lhs, const Polynomial<ValueType>& rhs);
 
+template<typename ValueType>
+Polynomial<ValueType> operator-(Polynomial<ValueType>&& lhs, const Polynomial<ValueType>& rhs);
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(const Polynomial<ValueType>& lhs, Polynomial<ValueType>&& rhs);
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(Polynomial<ValueType>&& lhs, Polynomial<ValueType>&& rhs);
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(Polynomial<ValueType>&& lhs, const ValueType& rhs);
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(const ValueType& lhs, Polynomial<ValueType>&& rhs);
+
 template<typename ValueType>
 Polynomial<ValueType> operator*(const Polynomial<ValueType>& lhs,
                                 const Polynomial<ValueType>& rhs);
@@ -74,6 +146,12 @@ Polynomial<ValueType> operator*(const Polynomial<ValueType>& lhs, const ValueTyp
 template<typename ValueType>
 Polynomial<ValueType> operator*(const ValueType& lhs, const Polynomial<ValueType>& rhs);
 
+template<typename ValueType>
+Polynomial<ValueType> operator*(Polynomial<ValueType>&& lhs, const ValueType& rhs);
+
+template<typename ValueType>
+Polynomial<ValueType> operator*(const ValueType& lhs, Polynomial<ValueType>&& rhs);
+
 template<typename ValueType>
 bool operator==(const Polynomial<ValueType>& lhs, const Polynomial<ValueType>& rhs);
 
@@ -105,6 +183,19 @@ Polynomial<ValueType> operator&(const Polynomial<ValueType>& f, const Polynomial
 template <typename ValueType>
 Polynomial<ValueType> x_pow(size_t pow);
 
+template <typename ValueType>
+Polynomial<ValueType> derivative(const Polynomial<ValueType>& poly);
+
+// returns the polynomial of degree < n passing through the n points (xs[i], ys[i]),
+// xs must be distinct; for field coefficient types
+template <typename ValueType>
+Polynomial<ValueType> interpolate(const std::vector<ValueType>& xs, const std::vector<ValueType>& ys);
+
+// returns {dividend / divisor, dividend % divisor}
+template <typename ValueType>
+std::pair<Polynomial<ValueType>, Polynomial<ValueType>> divmod(
+        const Polynomial<ValueType>& dividend, const Polynomial<ValueType>& divisor);
+
 template <typename ValueType>
 Polynomial<ValueType> operator/(Polynomial<ValueType> dividend,
                                 const Polynomial<ValueType>& divisor);
@@ -113,324 +204,2411 @@ template <typename ValueType>
 Polynomial<ValueType> operator%(const Polynomial<ValueType>& dividend,
                                 const Polynomial<ValueType>& divisor);
 
+// returns f(g(x)) mod h by baby steps g^i mod h for i < k ~ sqrt(deg f) and Horner's rule in g^k:
+// O(sqrt(deg f)) products modulo h plus O(deg f * deg h) for the sums of baby steps
+// (Brent-Kung's speedup would need fast matrix multiplication for those sums)
 template <typename ValueType>
-Polynomial<ValueType> operator,(Polynomial<ValueType> a, Polynomial<ValueType> b);
+Polynomial<ValueType> compose_mod_baby_giant(const Polynomial<ValueType>& f, const Polynomial<ValueType>& g,
+                                             const Polynomial<ValueType>& h);
+
+// reduction modulo a fixed f of positive degree n, shared by any number of calls.
+// fields keep the first n coefficients of 1 / rev(f) (Barrett reduction for polynomials): the remainder
+// of anything with less than 2n coefficients costs two multiplications, the quotient from the top half
+// and q * f modulo x^n. NTT-friendly ModInt coefficients also keep the transforms of both factors,
+// the latter folded to length n, so a reduction takes four transforms.
+// other coefficient types divide by f step by step, which is exact only for lc(f) = 1 or -1
+template <typename ValueType>
+class PolyModulus {
+private:
+    std::vector<ValueType> modulus;  // f, made monic for fields
+    std::vector<ValueType> rev_inv;  // 1 / rev(modulus) mod x^n
+    // NTT of rev_inv of length at least 2n - 1 and NTT of modulus mod x^m - 1 for m >= n,
+    // empty if not used
+    std::vector<ValueType> rev_inv_transform, modulus_transform;
 
-//
-// implementation:
-//
+    // remainder of a with at most 2n - 1 coefficients
+    std::vector<ValueType> reduce_short(std::vector<ValueType> a) const;
+    std::vector<ValueType> reduce_vector(std::vector<ValueType> a) const;
 
-template<typename ValueType>
-void Polynomial<ValueType>::delete_leading_zeros() {
-    while (!coeffs.empty() && coeffs.back() == ValueType(0)) {
-        coeffs.pop_back();
-    }
-}
+public:
+    // throws std::domain_error if deg f <= 0, or if ValueType is not a field and lc(f) is not 1 or -1
+    // (the division by f would not be exact)
+    explicit PolyModulus(const Polynomial<ValueType>& f);
 
-template<typename ValueType>
-Polynomial<ValueType>::Polynomial(const std::vector<ValueType>& coeffs_vec):
-        coeffs(coeffs_vec.begin(), coeffs_vec.end()), ZERO(ValueType(0)) {
-    delete_leading_zeros();
-}
+    int Degree() const;
+    // f, monic for fields
+    Polynomial<ValueType> Modulus() const;
+
+    // a mod f
+    Polynomial<ValueType> reduce(const Polynomial<ValueType>& a) const;
+    // a * b mod f and a^2 mod f, one multiplication (a squaring) more than reduce for residues a, b
+    Polynomial<ValueType> mulmod(const Polynomial<ValueType>& a, const Polynomial<ValueType>& b) const;
+    Polynomial<ValueType> sqrmod(const Polynomial<ValueType>& a) const;
+    // base^exp mod f by repeated squaring
+    Polynomial<ValueType> powmod(const Polynomial<ValueType>& base, unsigned long long exp) const;
+};
 
-template<typename ValueType>
-Polynomial<ValueType>::Polynomial(const ValueType& coeff): coeffs{coeff}, ZERO(ValueType(0)) {
-    delete_leading_zeros();
-}
+// returns base^exp mod f by repeated squaring with a PolyModulus, 0 if deg f <= 0;
+// for coefficient types that are not fields the leading coefficient of f must be 1 or -1,
+// otherwise the division is not exact and std::domain_error is thrown (by PolyModulus)
+template <typename ValueType>
+Polynomial<ValueType> powmod(const Polynomial<ValueType>& base, unsigned long long exp,
+                             const Polynomial<ValueType>& f);
 
-template<typename ValueType>
-template<typename Iter>
-Polynomial<ValueType>::Polynomial(Iter first, Iter last): coeffs(first, last), ZERO(ValueType(0)) {
-    delete_leading_zeros();
-}
+// returns the characteristic polynomial x^L - c_1 * x^(L - 1) - ... - c_L of the shortest
+// linear recurrence a_i = c_1 * a_(i - 1) + ... + c_L * a_(i - L) satisfied by the whole sequence
+// (Berlekamp-Massey); for field coefficient types
+template <typename ValueType>
+Polynomial<ValueType> berlekamp_massey(const std::vector<ValueType>& sequence);
 
-template<typename ValueType>
-int Polynomial<ValueType>::Degree() const {
-    return static_cast<int>(coeffs.size()) - 1;
-}
+// returns a_n of the recurrence with the given monic characteristic polynomial of degree L
+// and initial terms a_0, ..., a_(L - 1): a_n = sum r_i * a_i for r = x^n mod characteristic
+template <typename ValueType>
+ValueType nth_term(const std::vector<ValueType>& initial,
+                   const Polynomial<ValueType>& characteristic, unsigned long long n);
 
-template<typename ValueType>
-ValueType Polynomial<ValueType>::operator()(const ValueType& arg) const {
-    ValueType res(0);
-    ValueType cur_pow(1);
+// the same, with the recurrence recovered from the sequence by berlekamp_massey
+template <typename ValueType>
+ValueType nth_term(const std::vector<ValueType>& sequence, unsigned long long n);
 
-    for (int deg = 0; deg <= this->Degree(); ++deg) {
-        res += coeffs[deg] * cur_pow;
-        cur_pow *= arg;
-    }
-    return res;
-}
+// returns the monic gcd of a and b, see integer_gcd for integer coefficients
+template <typename ValueType>
+Polynomial<ValueType> operator,(Polynomial<ValueType> a, Polynomial<ValueType> b);
 
-template<typename ValueType>
-const ValueType& Polynomial<ValueType>::operator[](size_t index) const {
-    if (static_cast<int>(index) > Degree()) {
-        return ZERO;
-    } else {
-        return coeffs[index];
-    }
-}
+// returns {g, s, t}: g = (a, b) and s * a + t * b = g, for field coefficient types only
+template <typename ValueType>
+std::tuple<Polynomial<ValueType>, Polynomial<ValueType>, Polynomial<ValueType>> extended_gcd(
+        const Polynomial<ValueType>& a, const Polynomial<ValueType>& b);
+
+// integer coefficients (long long, Int from big_integer.h, ...): returns the gcd over Z with a positive
+// leading coefficient (the gcd of the contents times the gcd of the primitive parts, 0 for a = b = 0);
+// gcds modulo primes below 2^31 are combined by CRT into BigInteger until the candidate divides both a and b,
+// with as many primes as it takes: at the latest the CRT modulus passes twice the Mignotte bound
+// on the gcd coefficients, so the remainder sequence over Z with its coefficient growth is never formed.
+// BigInteger must hold the bound, e.g. integer_gcd<Int>(a, b) with Int from big_integer.h;
+// throws std::overflow_error if the gcd coefficients do not fit ValueType
+template <typename BigInteger, typename ValueType>
+Polynomial<ValueType> integer_gcd(const Polynomial<ValueType>& a, const Polynomial<ValueType>& b);
+
+// finite fields: ModInt coefficients with a prime modulus p
+
+// returns the distinct roots of a nonzero f in increasing order (Cantor-Zassenhaus)
+template <typename ValueType>
+std::vector<ValueType> find_roots(const Polynomial<ValueType>& f);
 
-template<typename ValueType>
-typename std::vector<ValueType>::const_iterator Polynomial<ValueType>::begin() const {
-    return coeffs.begin();
-}
+// returns {g_d, d} for every d such that the squarefree f has irreducible factors of degree d,
+// g_d being their monic product
+template <typename ValueType>
+std::vector<std::pair<Polynomial<ValueType>, int>> distinct_degree_factorization(Polynomial<ValueType> f);
 
-template<typename ValueType>
-typename std::vector<ValueType>::const_iterator Polynomial<ValueType>::end() const {
-    return coeffs.end();
-}
+// returns all the deg f complex roots of f, repeated by multiplicity, for floating and complex
+// coefficients (Aberth-Ehrlich); a root is final once its backward error is at the rounding level,
+// the others are returned as they are after max_iterations sweeps
+template <typename ValueType>
+std::vector<std::complex<typename fft::real_type<ValueType>::type>> find_complex_roots(
+        const Polynomial<ValueType>& f, int max_iterations = 100);
 
-template<typename ValueType>
-Polynomial<ValueType> &Polynomial<ValueType>::operator+=(const Polynomial<ValueType>& add) {
-    return (*this = *this + add);
-}
+// coefficient-level kernels used by the operators above
+namespace polynomial_detail {
 
-template<typename ValueType>
-Polynomial<ValueType> &Polynomial<ValueType>::operator+=(const ValueType& add) {
-    return (*this = *this + add);
-}
+template <typename ValueType>
+struct is_complex : std::false_type {};
 
-template<typename ValueType>
-Polynomial<ValueType> &Polynomial<ValueType>::operator-=(const Polynomial<ValueType>& add) {
-    return (*this = *this - add);
-}
+template <typename Real>
+struct is_complex<std::complex<Real>> : std::true_type {};
 
-template<typename ValueType>
-Polynomial<ValueType> &Polynomial<ValueType>::operator-=(const ValueType& add) {
-    return (*this = *this - add);
-}
+template <typename ValueType>
+struct is_modint : std::false_type {};
 
-template<typename ValueType>
-Polynomial<ValueType>& Polynomial<ValueType>::operator*=(const Polynomial<ValueType>& rhs) {
-    return (*this = *this * rhs);
-}
+template <uint32_t MOD>
+struct is_modint<ModInt<MOD>> : std::true_type {};
 
-template<typename ValueType>
-Polynomial<ValueType>& Polynomial<ValueType>::operator*=(const ValueType& rhs) {
-    return (*this = *this * rhs);
-}
+// FFT is used for floating and complex coefficients
+// when both factors have more coefficients than this
+const size_t FFT_MULTIPLY_THRESHOLD = 64;
 
-template<typename ValueType>
-Polynomial<ValueType> Polynomial<ValueType>::operator-() const {
-    std::vector<ValueType> res(coeffs);
-    for (auto& coeff : res) {
-        coeff = -coeff;
-    }
-    return Polynomial(res);
-}
+// the same for NTT with ModInt and three-prime NTT with long long coefficients
+const size_t NTT_MULTIPLY_THRESHOLD = 32;
 
-template<typename ValueType>
-Polynomial<ValueType> operator+(const Polynomial<ValueType>& lhs,
-                                const Polynomial<ValueType>& rhs) {
-    std::vector<ValueType> res;
-    for (int deg = 0; deg <= std::max(lhs.Degree(), rhs.Degree()); ++deg) {
-        res.push_back(lhs[deg] + rhs[deg]);
-    }
-    return Polynomial(res);
-}
+// Karatsuba falls back to the schoolbook multiplication for halves not longer than this
+const size_t KARATSUBA_THRESHOLD = 32;
 
-template<typename ValueType>
-Polynomial<ValueType> operator+(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
-    if (lhs.Degree() == -1) {
-        return Polynomial(ValueType(0) + rhs);
-    }
-    std::vector<ValueType> res(lhs.begin(), lhs.end());
-    res[0] += rhs;
-    return Polynomial(res);
-}
+// coefficient types with an ADL-visible
+// std::vector<ValueType> kronecker_multiply(const ValueType*, size_t, const ValueType*, size_t)
+// (e.g. Int from big_integer.h) multiply through it when both factors are longer than this
+const size_t KRONECKER_THRESHOLD = 8;
 
-template<typename ValueType>
-Polynomial<ValueType> operator+(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
-    return rhs + lhs;
-}
+template <typename ValueType, typename = void>
+struct has_kronecker_multiply : std::false_type {};
 
-template<typename ValueType>
-Polynomial<ValueType> operator-(const Polynomial<ValueType>& lhs,
-                                const Polynomial<ValueType>& rhs) {
-    return lhs + (-rhs);
-}
+template <typename ValueType>
+struct has_kronecker_multiply<ValueType, std::void_t<decltype(kronecker_multiply(
+        std::declval<const ValueType*>(), size_t(), std::declval<const ValueType*>(), size_t()))>>
+        : std::true_type {};
 
-template<typename ValueType>
-Polynomial<ValueType> operator-(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
-    return lhs + (-rhs);
-}
+// coefficient types where every nonzero element is invertible;
+// specialize it for other field types to enable the Newton-iteration algorithms
+template <typename ValueType>
+struct is_field : std::integral_constant<bool, std::is_floating_point<ValueType>::value ||
+                                               is_complex<ValueType>::value ||
+                                               is_modint<ValueType>::value> {};
 
-template<typename ValueType>
-Polynomial<ValueType> operator-(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
-    return lhs + (-rhs);
-}
+// division of fields goes through the power series inverse of the reversed divisor
+// when both the quotient and the divisor have more coefficients than this
+const size_t NEWTON_DIVISION_THRESHOLD = 64;
 
-template<typename ValueType>
-Polynomial<ValueType> operator*(const Polynomial<ValueType>& lhs,
-                                const Polynomial<ValueType>& rhs) {
-    const int LDEG = lhs.Degree(), RDEG = rhs.Degree();
-    if (LDEG == -1 || RDEG == -1) {
-        return (LDEG == -1 ? lhs : rhs);
-    }
+template <typename ValueType>
+std::vector<ValueType> naive_multiply(const ValueType* lhs, size_t lsize,
+                                      const ValueType* rhs, size_t rsize);
 
-    std::vector<ValueType> res(LDEG + RDEG + 1, ValueType(0));
+// res[0, 2n - 1) = lhs[0, n) * rhs[0, n), uses only +, - and * of ValueType
+// scratch must have room for karatsuba_scratch_size(n) values
+template <typename ValueType>
+void karatsuba(const ValueType* lhs, const ValueType* rhs, size_t n,
+               ValueType* res, ValueType* scratch, size_t threshold);
 
-    for (int ldeg = 0; ldeg <= LDEG; ++ldeg) {
-        for (int rdeg = 0; rdeg <= RDEG; ++rdeg) {
-            res[ldeg + rdeg] += lhs[ldeg] * rhs[rdeg];
-        }
-    }
-    return Polynomial(res);
-}
+inline size_t karatsuba_scratch_size(size_t n);
 
-template<typename ValueType>
-Polynomial<ValueType> operator*(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
-    std::vector<ValueType> res(lhs.begin(), lhs.end());
-    for (auto& coeff : res) {
-        coeff *= rhs;
-    }
-    return Polynomial(res);
-}
+// product of polynomials of any sizes: the longer one is cut into pieces
+// of the shorter one's size, each piece is multiplied by karatsuba
+template <typename ValueType>
+std::vector<ValueType> karatsuba_multiply(const ValueType* lhs, size_t lsize,
+                                          const ValueType* rhs, size_t rsize,
+                                          size_t threshold = KARATSUBA_THRESHOLD);
 
-template<typename ValueType>
-Polynomial<ValueType> operator*(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
-    return rhs * lhs;
-}
+// coefficients of the product, both sizes must be positive
+template <typename ValueType>
+std::vector<ValueType> multiply(const ValueType* lhs, size_t lsize,
+                                const ValueType* rhs, size_t rsize);
 
-template<typename ValueType>
-bool operator==(const Polynomial<ValueType>& lhs, const Polynomial<ValueType>& rhs) {
-    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
-}
+// first n coefficients of 1 / a (a[0] must be invertible) by Newton iteration:
+// inv <- inv * (2 - a * inv), doubling the number of correct coefficients each step
+template <typename ValueType>
+std::vector<ValueType> series_inverse(const ValueType* a, size_t asize, size_t n);
 
-template<typename ValueType>
-bool operator==(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
-    return (lhs.Degree() <= 0) && (lhs[0] == rhs);
-}
+// schoolbook long division in place: dividend is turned into the remainder
+template <typename ValueType>
+std::vector<ValueType> naive_divmod(std::vector<ValueType>& dividend,
+                                    const ValueType* divisor, size_t dsize);
 
-template<typename ValueType>
-bool operator==(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
-    return (rhs == lhs);
-}
+// first n coefficients of log(a), a[0] = 1: the integral of a' / a
+template <typename ValueType>
+std::vector<ValueType> series_log(const ValueType* a, size_t asize, size_t n);
 
-template<typename ValueType>
-bool operator!=(const Polynomial<ValueType>& lhs, const Polynomial<ValueType>& rhs) {
-    return !(lhs == rhs);
-}
+// first n coefficients of exp(a), a[0] = 0, by Newton iteration:
+// exp <- exp * (1 - log(exp) + a)
+template <typename ValueType>
+std::vector<ValueType> series_exp(const ValueType* a, size_t asize, size_t n);
 
-template<typename ValueType>
-bool operator!=(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
-    return !(lhs == rhs);
-}
+// first n coefficients of sqrt(a), a[0] = 1, by Newton iteration:
+// root <- (root + a / root) / 2
+template <typename ValueType>
+std::vector<ValueType> series_sqrt(const ValueType* a, size_t asize, size_t n);
 
-template<typename ValueType>
-bool operator!=(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
-    return !(lhs == rhs);
-}
+// base^exp by repeated squaring
+template <typename ValueType>
+ValueType power(ValueType base, unsigned long long exp);
 
-template<typename ValueType>
-ValueType abs(const ValueType& num) {
-    if (num > ValueType(0)) {
-        return num;
-    } else {
-        return -num;
-    }
-}
+// square root of a single coefficient: std::sqrt or the overload found by ADL (e.g. for ModInt)
+template <typename ValueType>
+ValueType coefficient_sqrt(const ValueType& num);
 
-template<typename ValueType>
-std::ostream& operator<<(std::ostream& out, const Polynomial<ValueType>& poly) {
-    if (poly.Degree() == -1) {
-        out << ValueType(0);
-    } else {
-        for (int deg = poly.Degree(); deg >= 0; --deg) {
-            if (poly[deg] == ValueType(0)) {
-                continue;
-            }
+// an integer as a coefficient, reduced modulo MOD for ModInt
+template <typename ValueType>
+ValueType from_integer(unsigned long long num);
 
-            ValueType abs_coeff = abs(poly[deg]);
+// quotient of the division of a field polynomial via series_inverse
+template <typename ValueType>
+std::vector<ValueType> newton_divide(const ValueType* dividend, size_t size,
+                                     const ValueType* divisor, size_t dsize);
 
-            if (abs_coeff == poly[deg]) {  // +
-                if (deg != poly.Degree()) {
-                    out << '+';
-                }
-            } else {  // -
-                out << '-';
-            }
+// remainder of the division of a by a monic mod of size msize > 1;
+// rev_inv holds the first max(size - msize + 1, 0) coefficients of 1 / rev(mod),
+// so that one inverse serves every reduction by the same modulus
+template <typename ValueType>
+std::vector<ValueType> reduce_with_inverse(std::vector<ValueType> a, const ValueType* mod, size_t msize,
+                                           const std::vector<ValueType>& rev_inv);
 
-            if (deg == 0 || abs_coeff != ValueType(1)) {
-                out << abs_coeff;
-                if (deg != 0) {
-                    out << '*';
-                }
-            }
+// multipoint evaluation uses Horner's rule for at most this many points
+// or below this degree, and for the whole input with floating and complex coefficients,
+// where the remainder tree is numerically unstable
+const size_t MULTIPOINT_THRESHOLD = 64;
 
-            if (deg != 0) {
-                out << 'x';
-                if (deg > 1) {
-                    out << '^' << deg;
-                }
-            }
-        }
-    }
-    return out;
-}
+// points are evaluated in blocks of this size, so that the values of a block stay in L1 cache
+const size_t HORNER_BLOCK = 256;
 
-// returns f(g(x))
+// out[j] = poly(points[j]) for every j; the loop over points is innermost,
+// so all the points of a block advance through the coefficients together
 template <typename ValueType>
-Polynomial<ValueType> operator&(const Polynomial<ValueType>& f, const Polynomial<ValueType>& g) {
-    Polynomial<ValueType> cur_pow(ValueType(1));
-    Polynomial<ValueType> res(ValueType(0));
+void horner_batch(const ValueType* coeffs, size_t size,
+                  const ValueType* points, size_t count, ValueType* out);
 
-    for (int deg = 0; deg <= f.Degree(); ++deg) {
-        res += f[deg] * cur_pow;
-        cur_pow *= g;
-    }
-    return res;
+#if defined(__AVX2__) && defined(__FMA__)
+// the same with AVX2: 32 doubles or 64 floats are kept in eight registers
+// through the whole coefficient loop, one FMA advances 4 doubles or 8 floats
+inline void horner_batch(const double* coeffs, size_t size,
+                         const double* points, size_t count, double* out);
+
+inline void horner_batch(const float* coeffs, size_t size,
+                         const float* points, size_t count, float* out);
+#endif
+
+// tree[node] = prod (x - points[i]) for i in [first, last),
+// the children of node are 2 * node and 2 * node + 1, the root is 1
+template <typename ValueType>
+void build_subproduct_tree(const ValueType* points, size_t first, size_t last, size_t node,
+                           std::vector<Polynomial<ValueType>>& tree);
+
+// out[i] = remainder(points[i]) for i in [first, last),
+// where remainder is the evaluated polynomial modulo tree[node]
+template <typename ValueType>
+void evaluate_descent(const Polynomial<ValueType>& remainder, const ValueType* points,
+                      size_t first, size_t last, size_t node,
+                      const std::vector<Polynomial<ValueType>>& tree, ValueType* out);
+
+// interpolation in the Newton form with divided differences, O(n^2)
+template <typename ValueType>
+Polynomial<ValueType> newton_interpolate(const std::vector<ValueType>& xs,
+                                         const std::vector<ValueType>& ys);
+
+// sum of weights[i] * tree[node] / (x - points[i]) for i in [first, last)
+template <typename ValueType>
+Polynomial<ValueType> combine_interpolation(const ValueType* points, const ValueType* weights,
+                                            size_t first, size_t last, size_t node,
+                                            const std::vector<Polynomial<ValueType>>& tree);
+
+// composition uses Horner's rule for parts of f with at most this many coefficients
+const size_t COMPOSITION_THRESHOLD = 8;
+
+// f_part(g) for f_part = f[first] + f[first + 1] * x + ... + f[first + size - 1] * x^(size - 1),
+// size is a power of two and g_pows[i] = g^(2^i)
+template <typename ValueType>
+Polynomial<ValueType> compose_part(const Polynomial<ValueType>& f, size_t first, size_t size,
+                                   const Polynomial<ValueType>& g,
+                                   const std::vector<Polynomial<ValueType>>& g_pows);
+
+// half-GCD falls back to the classical Euclidean algorithm below this degree
+const int HALF_GCD_THRESHOLD = 128;
+
+// 2x2 matrix of polynomials mapping a pair of polynomials to a later pair of their remainder sequence
+template <typename ValueType>
+struct TransitionMatrix {
+    Polynomial<ValueType> a00, a01, a10, a11;
+
+    TransitionMatrix();  // identity
+};
+
+template <typename ValueType>
+TransitionMatrix<ValueType> operator*(const TransitionMatrix<ValueType>& lhs,
+                                      const TransitionMatrix<ValueType>& rhs);
+
+// (a, b) <- matrix * (a, b)
+template <typename ValueType>
+void apply(const TransitionMatrix<ValueType>& matrix,
+           Polynomial<ValueType>& a, Polynomial<ValueType>& b);
+
+// one step of the Euclidean algorithm: (a, b) <- (b, a % b), returns its matrix
+template <typename ValueType>
+TransitionMatrix<ValueType> euclid_step(Polynomial<ValueType>& a, Polynomial<ValueType>& b);
+
+// poly / x^k
+template <typename ValueType>
+Polynomial<ValueType> div_x_pow(const Polynomial<ValueType>& poly, int k);
+
+// Knuth-Schonhage half-GCD, deg a > deg b:
+// returns the matrix leading to the consecutive remainders (c, d) with deg c >= m > deg d,
+// where m = ceil(deg a / 2)
+template <typename ValueType>
+TransitionMatrix<ValueType> half_gcd(const Polynomial<ValueType>& a, const Polynomial<ValueType>& b);
+
+// (a, b) <- (gcd, 0) for deg a >= deg b, the product of used transitions
+// is accumulated into matrix if it is not null
+template <typename ValueType>
+void reduce_to_gcd(Polynomial<ValueType>& a, Polynomial<ValueType>& b,
+                   TransitionMatrix<ValueType>* matrix);
+
+// a^exp modulo mod
+inline uint32_t power_mod(uint32_t a, uint64_t exp, uint32_t mod);
+
+// deterministic Miller-Rabin, the bases 2, 7 and 61 are enough below 2^32
+inline bool is_prime(uint32_t n);
+
+// the monic gcd modulo the prime mod of nonzero a and b given by coefficients in [0, mod)
+// without leading zeros, by the Euclidean algorithm
+inline std::vector<uint32_t> gcd_mod(std::vector<uint32_t> a, std::vector<uint32_t> b, uint32_t mod);
+
+// gcd of |a| and |b| by the Euclidean algorithm
+template <typename BigInteger>
+BigInteger gcd_value(BigInteger a, BigInteger b);
+
+// gcd of the coefficients, positive for nonzero coeffs
+template <typename BigInteger>
+BigInteger content(const std::vector<BigInteger>& coeffs);
+
+// whether the primitive divisor divides the nonzero poly over Z, by long division
+template <typename BigInteger>
+bool divides(const std::vector<BigInteger>& divisor, const std::vector<BigInteger>& poly);
+
+// appends the roots of g, a monic product of distinct linear factors, to roots:
+// gcd(g, (x + a)^((p - 1) / 2) - 1) for a random a splits off the factors x - r
+// with r + a being a nonzero square, about a half of them
+template <typename ValueType>
+void split_roots(const Polynomial<ValueType>& g, std::mt19937_64& rng, std::vector<ValueType>& roots);
+
+// starting points of the Aberth iteration: for every edge (k, l) of the upper convex hull
+// of the points (i, log |coeffs[i]|), l - k points on the circle of radius (|coeffs[k]| / |coeffs[l]|)^(1 / (l - k))
+template <typename Real>
+std::vector<std::complex<Real>> newton_polygon_start(const std::vector<std::complex<Real>>& coeffs);
+
+// the Aberth correction 1 / (p'(z) / p(z) - sum 1 / (z - z_j)) needs p' / p;
+// returns false instead if |p(z)| is within the rounding error bound
+// eps * sum (4i + 1) |coeffs[i]| |z|^i of its evaluation (the backward error is negligible);
+// |z| > 1 evaluates the reversed polynomial at 1 / z, so that nothing overflows
+template <typename Real>
+bool log_derivative(const std::vector<std::complex<Real>>& coeffs, const std::vector<Real>& bounds,
+                    const std::vector<Real>& rev_bounds, std::complex<Real> z, std::complex<Real>& res);
+
+}  // namespace polynomial_detail
+
+//
+// implementation:
+//
+
+namespace polynomial_detail {
+
+template <typename ValueType>
+std::vector<ValueType> naive_multiply(const ValueType* lhs, size_t lsize,
+                                      const ValueType* rhs, size_t rsize) {
+    std::vector<ValueType> res(lsize + rsize - 1, ValueType(0));
+    for (size_t ldeg = 0; ldeg < lsize; ++ldeg) {
+        for (size_t rdeg = 0; rdeg < rsize; ++rdeg) {
+            res[ldeg + rdeg] += lhs[ldeg] * rhs[rdeg];
+        }
+    }
+    return res;
+}
+
+template <typename ValueType>
+void karatsuba(const ValueType* lhs, const ValueType* rhs, size_t n,
+               ValueType* res, ValueType* scratch, size_t threshold) {
+    if (n <= std::max<size_t>(threshold, 1)) {
+        for (size_t i = 0; i + 1 < 2 * n; ++i) {
+            res[i] = ValueType(0);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                res[i + j] = res[i + j] + lhs[i] * rhs[j];
+            }
+        }
+        return;
+    }
+
+    // lhs = lhs_low + x^half * lhs_high, the same for rhs
+    const size_t half = n / 2, high = n - half;
+
+    // res[0, 2 * half - 1) = lhs_low * rhs_low, res[2 * half, 2n - 1) = lhs_high * rhs_high
+    karatsuba(lhs, rhs, half, res, scratch, threshold);
+    res[2 * half - 1] = ValueType(0);
+    karatsuba(lhs + half, rhs + half, high, res + 2 * half, scratch, threshold);
+
+    // mid = (lhs_low + lhs_high) * (rhs_low + rhs_high) - low - high
+    ValueType* lsum = scratch;
+    ValueType* rsum = lsum + high;
+    ValueType* mid = rsum + high;
+    for (size_t i = 0; i < high; ++i) {
+        lsum[i] = (i < half ? lhs[i] + lhs[half + i] : lhs[half + i]);
+        rsum[i] = (i < half ? rhs[i] + rhs[half + i] : rhs[half + i]);
+    }
+    karatsuba(lsum, rsum, high, mid, mid + 2 * high - 1, threshold);
+
+    for (size_t i = 0; i + 1 < 2 * half; ++i) {
+        mid[i] = mid[i] - res[i];
+    }
+    for (size_t i = 0; i + 1 < 2 * high; ++i) {
+        mid[i] = mid[i] - res[2 * half + i];
+    }
+    for (size_t i = 0; i + 1 < 2 * high; ++i) {
+        res[half + i] = res[half + i] + mid[i];
+    }
+}
+
+inline size_t karatsuba_scratch_size(size_t n) {
+    size_t res = 0;
+    for (; n > 1; n -= n / 2) {
+        res += 4 * (n - n / 2);
+    }
+    return res;
+}
+
+template <typename ValueType>
+std::vector<ValueType> karatsuba_multiply(const ValueType* lhs, size_t lsize,
+                                          const ValueType* rhs, size_t rsize,
+                                          size_t threshold) {
+    if (lsize < rsize) {
+        std::swap(lhs, rhs);
+        std::swap(lsize, rsize);
+    }
+    const size_t n = rsize;
+
+    std::vector<ValueType> res(lsize + rsize - 1, ValueType(0));
+    std::vector<ValueType> piece(n, ValueType(0)), piece_product(2 * n - 1);
+    std::vector<ValueType> scratch(karatsuba_scratch_size(n));
+
+    for (size_t offset = 0; offset < lsize; offset += n) {
+        const size_t piece_size = std::min(n, lsize - offset);
+        const ValueType* piece_begin = lhs + offset;
+        if (piece_size < n) {  // the last piece is padded with zeros
+            std::copy(piece_begin, piece_begin + piece_size, piece.begin());
+            piece_begin = piece.data();
+        }
+
+        karatsuba(piece_begin, rhs, n, piece_product.data(), scratch.data(), threshold);
+        for (size_t i = 0; i < piece_size + n - 1; ++i) {
+            res[offset + i] = res[offset + i] + piece_product[i];
+        }
+    }
+    return res;
+}
+
+template <typename ValueType>
+std::vector<ValueType> multiply(const ValueType* lhs, size_t lsize,
+                                const ValueType* rhs, size_t rsize) {
+    if (std::min(lsize, rsize) > FFT_MULTIPLY_THRESHOLD) {
+        if constexpr (std::is_floating_point<ValueType>::value) {
+            return fft::multiply_real(lhs, lsize, rhs, rsize);
+        } else if constexpr (is_complex<ValueType>::value) {
+            return fft::multiply_complex(lhs, lsize, rhs, rsize);
+        }
+    }
+    if (std::min(lsize, rsize) > NTT_MULTIPLY_THRESHOLD) {
+        if constexpr (is_modint<ValueType>::value) {
+            const size_t max_size = fft::max_ntt_size<ValueType::modulus>();
+            if (fft::transform_size(lsize + rsize - 1) <= max_size) {
+                return fft::multiply_ntt(lhs, lsize, rhs, rsize);
+            } else if (max_size >= fft::max_ntt_size<fft::CRT_MOD1>()) {
+                // longer than one transform, but the blocks in MOD itself take a third of the work
+                return fft::multiply_blocks(lhs, lsize, rhs, rsize, max_size / 2,
+                                            fft::multiply_ntt<ValueType::modulus>);
+            } else {
+                return fft::multiply_arbitrary_mod(lhs, lsize, rhs, rsize);
+            }
+        } else if constexpr (std::is_same<ValueType, long long>::value) {
+            return fft::multiply_exact(lhs, lsize, rhs, rsize);
+        }
+    }
+    if constexpr (has_kronecker_multiply<ValueType>::value) {
+        if (std::min(lsize, rsize) > KRONECKER_THRESHOLD) {
+            return kronecker_multiply(lhs, lsize, rhs, rsize);
+        }
+    }
+    if (std::min(lsize, rsize) > KARATSUBA_THRESHOLD) {
+        return karatsuba_multiply(lhs, lsize, rhs, rsize);
+    }
+    return naive_multiply(lhs, lsize, rhs, rsize);
+}
+
+template <typename ValueType>
+std::vector<ValueType> series_inverse(const ValueType* a, size_t asize, size_t n) {
+    std::vector<ValueType> inv{ValueType(1) / a[0]};
+    for (size_t len = 1; len < n; ) {
+        len = std::min(2 * len, n);
+        // a * inv = 1 + O(x^(len / 2)), only its first len coefficients matter
+        std::vector<ValueType> correction =
+                multiply(a, std::min(asize, len), inv.data(), inv.size());
+        correction.resize(len, ValueType(0));
+        for (auto& coeff : correction) {
+            coeff = -coeff;
+        }
+        correction[0] += ValueType(2);
+
+        inv = multiply(inv.data(), inv.size(), correction.data(), len);
+        inv.resize(len);
+    }
+    inv.resize(n, ValueType(0));
+    return inv;
+}
+
+template <typename ValueType>
+std::vector<ValueType> series_log(const ValueType* a, size_t asize, size_t n) {
+    if (n <= 1) {
+        return std::vector<ValueType>(n, ValueType(0));
+    }
+    std::vector<ValueType> deriv(std::min(asize, n) - 1);
+    for (size_t deg = 0; deg < deriv.size(); ++deg) {
+        deriv[deg] = a[deg + 1] * ValueType(static_cast<int>(deg + 1));
+    }
+    std::vector<ValueType> inv = series_inverse(a, asize, n - 1);
+
+    std::vector<ValueType> res(n, ValueType(0));
+    if (!deriv.empty()) {
+        std::vector<ValueType> quotient = multiply(deriv.data(), deriv.size(), inv.data(), n - 1);
+        for (size_t deg = 1; deg < n; ++deg) {
+            res[deg] = quotient[deg - 1] / ValueType(static_cast<int>(deg));
+        }
+    }
+    return res;
+}
+
+template <typename ValueType>
+std::vector<ValueType> series_exp(const ValueType* a, size_t asize, size_t n) {
+    std::vector<ValueType> res{ValueType(1)};
+    for (size_t len = 1; len < n; ) {
+        len = std::min(2 * len, n);
+        std::vector<ValueType> correction = series_log(res.data(), res.size(), len);
+        for (size_t deg = 0; deg < len; ++deg) {
+            correction[deg] = (deg < asize ? a[deg] : ValueType(0)) - correction[deg];
+        }
+        correction[0] += ValueType(1);
+
+        res = multiply(res.data(), res.size(), correction.data(), len);
+        res.resize(len);
+    }
+    res.resize(n, ValueType(0));
+    return res;
+}
+
+template <typename ValueType>
+std::vector<ValueType> series_sqrt(const ValueType* a, size_t asize, size_t n) {
+    const ValueType INV2 = ValueType(1) / ValueType(2);
+    std::vector<ValueType> res{ValueType(1)};
+    for (size_t len = 1; len < n; ) {
+        len = std::min(2 * len, n);
+        std::vector<ValueType> inv = series_inverse(res.data(), res.size(), len);
+        std::vector<ValueType> quotient = multiply(a, std::min(asize, len), inv.data(), len);
+        res.resize(len, ValueType(0));
+        for (size_t deg = 0; deg < len; ++deg) {
+            res[deg] = (res[deg] + (deg < quotient.size() ? quotient[deg] : ValueType(0))) * INV2;
+        }
+    }
+    res.resize(n, ValueType(0));
+    return res;
+}
+
+template <typename ValueType>
+ValueType power(ValueType base, unsigned long long exp) {
+    ValueType res(1);
+    for (; exp; exp >>= 1) {
+        if (exp & 1) {
+            res *= base;
+        }
+        base *= base;
+    }
+    return res;
+}
+
+template <typename ValueType>
+ValueType coefficient_sqrt(const ValueType& num) {
+    using std::sqrt;
+    return sqrt(num);
+}
+
+template <typename ValueType>
+ValueType from_integer(unsigned long long num) {
+    if constexpr (is_modint<ValueType>::value) {
+        return ValueType(static_cast<long long>(num % ValueType::modulus));
+    } else {
+        return ValueType(num);
+    }
+}
+
+template <typename ValueType>
+std::vector<ValueType> naive_divmod(std::vector<ValueType>& dividend,
+                                    const ValueType* divisor, size_t dsize) {
+    if (dividend.size() < dsize) {
+        return {};
+    }
+    std::vector<ValueType> quotient(dividend.size() - dsize + 1, ValueType(0));
+    const ValueType& lead = divisor[dsize - 1];
+
+    for (size_t pow = quotient.size(); pow-- > 0; ) {
+        ValueType& top = dividend[pow + dsize - 1];
+        if (top == ValueType(0)) {
+            continue;
+        }
+        ValueType coeff = top / lead;
+        if (coeff == ValueType(0)) {  // integer coefficients: the leading term is not divisible
+            break;
+        }
+
+        quotient[pow] = coeff;
+        for (size_t deg = 0; deg + 1 < dsize; ++deg) {
+            dividend[pow + deg] -= coeff * divisor[deg];
+        }
+        if constexpr (is_field<ValueType>::value) {
+            top = ValueType(0);  // exactly, even with rounding errors
+        } else {
+            top -= coeff * lead;
+            if (top != ValueType(0)) {  // inexact integer division, the leading term stays
+                break;
+            }
+        }
+    }
+    return quotient;
+}
+
+template <typename ValueType>
+std::vector<ValueType> newton_divide(const ValueType* dividend, size_t size,
+                                     const ValueType* divisor, size_t dsize) {
+    // rev(q) = rev(dividend) / rev(divisor) mod x^(size - dsize + 1)
+    const size_t qsize = size - dsize + 1;
+    std::vector<ValueType> rev_dividend(dividend + size - qsize, dividend + size);
+    std::vector<ValueType> rev_divisor(divisor, divisor + dsize);
+    std::reverse(rev_dividend.begin(), rev_dividend.end());
+    std::reverse(rev_divisor.begin(), rev_divisor.end());
+
+    std::vector<ValueType> inv = series_inverse(rev_divisor.data(), dsize, qsize);
+    std::vector<ValueType> quotient = multiply(rev_dividend.data(), qsize, inv.data(), qsize);
+    quotient.resize(qsize);
+    std::reverse(quotient.begin(), quotient.end());
+    return quotient;
+}
+
+template <typename ValueType>
+std::vector<ValueType> reduce_with_inverse(std::vector<ValueType> a, const ValueType* mod, size_t msize,
+                                           const std::vector<ValueType>& rev_inv) {
+    if (a.size() < msize) {
+        return a;
+    }
+    const size_t qsize = a.size() - msize + 1, rsize = msize - 1;
+    if (std::min(qsize, msize) <= NEWTON_DIVISION_THRESHOLD) {
+        naive_divmod(a, mod, msize);
+        a.resize(rsize);
+        return a;
+    }
+
+    // rev(q) = rev(a) * rev_inv mod x^qsize
+    std::vector<ValueType> rev_a(a.rbegin(), a.rbegin() + qsize);
+    std::vector<ValueType> quotient = multiply(rev_a.data(), qsize, rev_inv.data(), qsize);
+    quotient.resize(qsize);
+    std::reverse(quotient.begin(), quotient.end());
+
+    // only the lowest rsize coefficients of q * mod matter
+    std::vector<ValueType> product = multiply(quotient.data(), std::min(qsize, rsize), mod, rsize);
+    a.resize(rsize);
+    for (size_t deg = 0; deg < rsize; ++deg) {
+        a[deg] -= product[deg];
+    }
+    return a;
+}
+
+}  // namespace polynomial_detail
+
+template<typename ValueType>
+void Polynomial<ValueType>::delete_leading_zeros() {
+    while (!coeffs.empty() && coeffs.back() == ValueType(0)) {
+        coeffs.pop_back();
+    }
+}
+
+template<typename ValueType>
+Polynomial<ValueType>::Polynomial(const std::vector<ValueType>& coeffs_vec):
+        coeffs(coeffs_vec.begin(), coeffs_vec.end()), ZERO(ValueType(0)) {
+    delete_leading_zeros();
+}
+
+template<typename ValueType>
+Polynomial<ValueType>::Polynomial(std::vector<ValueType>&& coeffs_vec):
+        coeffs(std::move(coeffs_vec)), ZERO(ValueType(0)) {
+    delete_leading_zeros();
+}
+
+template<typename ValueType>
+Polynomial<ValueType>::Polynomial(const ValueType& coeff): coeffs{coeff}, ZERO(ValueType(0)) {
+    delete_leading_zeros();
+}
+
+template<typename ValueType>
+template<typename Iter>
+Polynomial<ValueType>::Polynomial(Iter first, Iter last): coeffs(first, last), ZERO(ValueType(0)) {
+    delete_leading_zeros();
+}
+
+template<typename ValueType>
+int Polynomial<ValueType>::Degree() const {
+    return static_cast<int>(coeffs.size()) - 1;
+}
+
+template<typename ValueType>
+void Polynomial<ValueType>::reserve(size_t degree) {
+    coeffs.reserve(degree + 1);
+}
+
+template<typename ValueType>
+ValueType Polynomial<ValueType>::operator()(const ValueType& arg) const {
+    // Horner's rule: one multiplication and one addition per coefficient
+    ValueType res(0);
+    for (size_t deg = coeffs.size(); deg-- > 0; ) {
+        res = res * arg + coeffs[deg];
+    }
+    return res;
+}
+
+template<typename ValueType>
+std::vector<ValueType> Polynomial<ValueType>::evaluate(const std::vector<ValueType>& points) const {
+    using namespace polynomial_detail;
+
+    std::vector<ValueType> res(points.size());
+    if (points.size() <= MULTIPOINT_THRESHOLD || coeffs.size() <= MULTIPOINT_THRESHOLD ||
+        std::is_floating_point<ValueType>::value || is_complex<ValueType>::value) {
+        horner_batch(coeffs.data(), coeffs.size(), points.data(), points.size(), res.data());
+        return res;
+    }
+
+    // with much more points than coefficients the points are split into chunks
+    // of the polynomial's size, each chunk has its own tree
+    const size_t chunk = std::max(coeffs.size(), MULTIPOINT_THRESHOLD);
+    std::vector<Polynomial<ValueType>> tree;
+    for (size_t first = 0; first < points.size(); first += chunk) {
+        const size_t count = std::min(chunk, points.size() - first);
+        tree.assign(4 * count, Polynomial<ValueType>());
+        build_subproduct_tree(points.data() + first, 0, count, 1, tree);
+        evaluate_descent(*this % tree[1], points.data() + first, 0, count, 1, tree,
+                         res.data() + first);
+    }
+    return res;
+}
+
+template<typename ValueType>
+void Polynomial<ValueType>::evaluate(const ValueType* points, size_t count, ValueType* out) const {
+    polynomial_detail::horner_batch(coeffs.data(), coeffs.size(), points, count, out);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> Polynomial<ValueType>::inverse(size_t n) const {
+    static_assert(polynomial_detail::is_field<ValueType>::value,
+                  "power series operations need invertible coefficients");
+    if (coeffs.empty() || coeffs[0] == ValueType(0)) {
+        throw std::domain_error("Polynomial::inverse: zero constant term");
+    }
+    if (n == 0) {
+        return Polynomial<ValueType>();
+    }
+    return Polynomial(polynomial_detail::series_inverse(coeffs.data(), coeffs.size(), n));
+}
+
+template<typename ValueType>
+Polynomial<ValueType> Polynomial<ValueType>::log(size_t n) const {
+    static_assert(polynomial_detail::is_field<ValueType>::value,
+                  "power series operations need invertible coefficients");
+    if (coeffs.empty() || coeffs[0] != ValueType(1)) {
+        throw std::domain_error("Polynomial::log: constant term is not 1");
+    }
+    return Polynomial(polynomial_detail::series_log(coeffs.data(), coeffs.size(), n));
+}
+
+template<typename ValueType>
+Polynomial<ValueType> Polynomial<ValueType>::exp(size_t n) const {
+    static_assert(polynomial_detail::is_field<ValueType>::value,
+                  "power series operations need invertible coefficients");
+    if (!coeffs.empty() && coeffs[0] != ValueType(0)) {
+        throw std::domain_error("Polynomial::exp: nonzero constant term");
+    }
+    return Polynomial(polynomial_detail::series_exp(coeffs.data(), coeffs.size(), n));
+}
+
+template<typename ValueType>
+Polynomial<ValueType> Polynomial<ValueType>::sqrt(size_t n) const {
+    static_assert(polynomial_detail::is_field<ValueType>::value,
+                  "power series operations need invertible coefficients");
+    if (coeffs.empty()) {
+        return Polynomial<ValueType>();
+    }
+    size_t low = 0;
+    while (coeffs[low] == ValueType(0)) {
+        ++low;
+    }
+    if (low % 2 != 0) {
+        throw std::domain_error("Polynomial::sqrt: the lowest term has an odd degree");
+    }
+    if (low / 2 >= n) {
+        return Polynomial<ValueType>();
+    }
+
+    // f = c * x^low * h with h[0] = 1, sqrt(f) = sqrt(c) * x^(low / 2) * sqrt(h)
+    const ValueType root = polynomial_detail::coefficient_sqrt(coeffs[low]);
+    const ValueType inv_lowest = ValueType(1) / coeffs[low];
+    std::vector<ValueType> reduced(coeffs.begin() + low, coeffs.end());
+    for (auto& coeff : reduced) {
+        coeff *= inv_lowest;
+    }
+
+    std::vector<ValueType> res(low / 2, ValueType(0));
+    for (const auto& coeff : polynomial_detail::series_sqrt(reduced.data(), reduced.size(), n - low / 2)) {
+        res.push_back(coeff * root);
+    }
+    return Polynomial(std::move(res));
+}
+
+template<typename ValueType>
+Polynomial<ValueType> Polynomial<ValueType>::pow(unsigned long long k, size_t n) const {
+    static_assert(polynomial_detail::is_field<ValueType>::value,
+                  "power series operations need invertible coefficients");
+    if (n == 0) {
+        return Polynomial<ValueType>();
+    }
+    if (k == 0) {
+        return Polynomial<ValueType>(ValueType(1));
+    }
+    if (coeffs.empty()) {
+        return Polynomial<ValueType>();
+    }
+    size_t low = 0;
+    while (coeffs[low] == ValueType(0)) {
+        ++low;
+    }
+    if (low > 0 && k >= (n + low - 1) / low) {  // low * k >= n
+        return Polynomial<ValueType>();
+    }
+
+    // f = c * x^low * h with h[0] = 1, f^k = c^k * x^(low * k) * exp(k * log(h))
+    const size_t shift = low * k, len = n - shift;
+    const ValueType inv_lowest = ValueType(1) / coeffs[low];
+    std::vector<ValueType> reduced(coeffs.begin() + low,
+                                   coeffs.begin() + std::min(coeffs.size(), low + len));
+    for (auto& coeff : reduced) {
+        coeff *= inv_lowest;
+    }
+
+    std::vector<ValueType> log = polynomial_detail::series_log(reduced.data(), reduced.size(), len);
+    const ValueType exponent = polynomial_detail::from_integer<ValueType>(k);
+    for (auto& coeff : log) {
+        coeff *= exponent;
+    }
+    const ValueType lowest_pow = polynomial_detail::power(coeffs[low], k);
+
+    std::vector<ValueType> res(shift, ValueType(0));
+    for (const auto& coeff : polynomial_detail::series_exp(log.data(), len, len)) {
+        res.push_back(coeff * lowest_pow);
+    }
+    return Polynomial(std::move(res));
+}
+
+template<typename ValueType>
+const ValueType& Polynomial<ValueType>::operator[](size_t index) const {
+    if (static_cast<int>(index) > Degree()) {
+        return ZERO;
+    } else {
+        return coeffs[index];
+    }
+}
+
+template<typename ValueType>
+typename std::vector<ValueType>::const_iterator Polynomial<ValueType>::begin() const {
+    return coeffs.begin();
+}
+
+template<typename ValueType>
+typename std::vector<ValueType>::const_iterator Polynomial<ValueType>::end() const {
+    return coeffs.end();
+}
+
+template<typename ValueType>
+Polynomial<ValueType> &Polynomial<ValueType>::operator+=(const Polynomial<ValueType>& add) {
+    if (coeffs.size() < add.coeffs.size()) {
+        coeffs.resize(add.coeffs.size(), ValueType(0));
+    }
+    for (size_t deg = 0; deg < add.coeffs.size(); ++deg) {
+        coeffs[deg] += add.coeffs[deg];
+    }
+    delete_leading_zeros();
+    return *this;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> &Polynomial<ValueType>::operator+=(const ValueType& add) {
+    if (coeffs.empty()) {
+        coeffs.push_back(add);
+    } else {
+        coeffs[0] += add;
+    }
+    delete_leading_zeros();
+    return *this;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> &Polynomial<ValueType>::operator-=(const Polynomial<ValueType>& add) {
+    if (coeffs.size() < add.coeffs.size()) {
+        coeffs.resize(add.coeffs.size(), ValueType(0));
+    }
+    for (size_t deg = 0; deg < add.coeffs.size(); ++deg) {
+        coeffs[deg] -= add.coeffs[deg];
+    }
+    delete_leading_zeros();
+    return *this;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> &Polynomial<ValueType>::operator-=(const ValueType& add) {
+    if (coeffs.empty()) {
+        coeffs.push_back(-add);
+    } else {
+        coeffs[0] -= add;
+    }
+    delete_leading_zeros();
+    return *this;
+}
+
+template<typename ValueType>
+Polynomial<ValueType>& Polynomial<ValueType>::operator*=(const Polynomial<ValueType>& rhs) {
+    return (*this = *this * rhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType>& Polynomial<ValueType>::operator*=(const ValueType& rhs) {
+    for (auto& coeff : coeffs) {
+        coeff *= rhs;
+    }
+    delete_leading_zeros();
+    return *this;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> Polynomial<ValueType>::operator-() const& {
+    return -Polynomial(*this);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> Polynomial<ValueType>::operator-() && {
+    for (auto& coeff : coeffs) {
+        coeff = -coeff;
+    }
+    return std::move(*this);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(const Polynomial<ValueType>& lhs,
+                                const Polynomial<ValueType>& rhs) {
+    Polynomial<ValueType> res;
+    res.reserve(std::max(lhs.Degree(), rhs.Degree()));
+    res += lhs;
+    res += rhs;
+    return res;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    Polynomial<ValueType> res(lhs);
+    res += rhs;
+    return res;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    return rhs + lhs;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(Polynomial<ValueType>&& lhs, const Polynomial<ValueType>& rhs) {
+    return std::move(lhs += rhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(const Polynomial<ValueType>& lhs, Polynomial<ValueType>&& rhs) {
+    return std::move(rhs += lhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(Polynomial<ValueType>&& lhs, Polynomial<ValueType>&& rhs) {
+    return std::move(lhs += rhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(Polynomial<ValueType>&& lhs, const ValueType& rhs) {
+    return std::move(lhs += rhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(const ValueType& lhs, Polynomial<ValueType>&& rhs) {
+    return std::move(rhs += lhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(const Polynomial<ValueType>& lhs,
+                                const Polynomial<ValueType>& rhs) {
+    Polynomial<ValueType> res;
+    res.reserve(std::max(lhs.Degree(), rhs.Degree()));
+    res += lhs;
+    res -= rhs;
+    return res;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    Polynomial<ValueType> res(lhs);
+    res -= rhs;
+    return res;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    Polynomial<ValueType> res = -rhs;
+    res += lhs;
+    return res;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(Polynomial<ValueType>&& lhs, const Polynomial<ValueType>& rhs) {
+    return std::move(lhs -= rhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(const Polynomial<ValueType>& lhs, Polynomial<ValueType>&& rhs) {
+    Polynomial<ValueType> res = -std::move(rhs);
+    res += lhs;
+    return res;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(Polynomial<ValueType>&& lhs, Polynomial<ValueType>&& rhs) {
+    return std::move(lhs -= rhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(Polynomial<ValueType>&& lhs, const ValueType& rhs) {
+    return std::move(lhs -= rhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(const ValueType& lhs, Polynomial<ValueType>&& rhs) {
+    Polynomial<ValueType> res = -std::move(rhs);
+    res += lhs;
+    return res;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator*(const Polynomial<ValueType>& lhs,
+                                const Polynomial<ValueType>& rhs) {
+    const int LDEG = lhs.Degree(), RDEG = rhs.Degree();
+    if (LDEG == -1 || RDEG == -1) {
+        return (LDEG == -1 ? lhs : rhs);
+    }
+
+    return Polynomial(polynomial_detail::multiply(&lhs[0], LDEG + 1, &rhs[0], RDEG + 1));
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator*(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    Polynomial<ValueType> res(lhs);
+    res *= rhs;
+    return res;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator*(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    return rhs * lhs;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator*(Polynomial<ValueType>&& lhs, const ValueType& rhs) {
+    return std::move(lhs *= rhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator*(const ValueType& lhs, Polynomial<ValueType>&& rhs) {
+    return std::move(rhs *= lhs);
+}
+
+template<typename ValueType>
+bool operator==(const Polynomial<ValueType>& lhs, const Polynomial<ValueType>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template<typename ValueType>
+bool operator==(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    return (lhs.Degree() <= 0) && (lhs[0] == rhs);
+}
+
+template<typename ValueType>
+bool operator==(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    return (rhs == lhs);
+}
+
+template<typename ValueType>
+bool operator!=(const Polynomial<ValueType>& lhs, const Polynomial<ValueType>& rhs) {
+    return !(lhs == rhs);
+}
+
+template<typename ValueType>
+bool operator!=(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    return !(lhs == rhs);
+}
+
+template<typename ValueType>
+bool operator!=(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    return !(lhs == rhs);
+}
+
+template<typename ValueType>
+ValueType abs(const ValueType& num) {
+    if (num > ValueType(0)) {
+        return num;
+    } else {
+        return -num;
+    }
+}
+
+template<typename ValueType>
+std::ostream& operator<<(std::ostream& out, const Polynomial<ValueType>& poly) {
+    if (poly.Degree() == -1) {
+        out << ValueType(0);
+    } else {
+        for (int deg = poly.Degree(); deg >= 0; --deg) {
+            if (poly[deg] == ValueType(0)) {
+                continue;
+            }
+
+            ValueType abs_coeff = abs(poly[deg]);
+
+            if (abs_coeff == poly[deg]) {  // +
+                if (deg != poly.Degree()) {
+                    out << '+';
+                }
+            } else {  // -
+                out << '-';
+            }
+
+            if (deg == 0 || abs_coeff != ValueType(1)) {
+                out << abs_coeff;
+                if (deg != 0) {
+                    out << '*';
+                }
+            }
+
+            if (deg != 0) {
+                out << 'x';
+                if (deg > 1) {
+                    out << '^' << deg;
+                }
+            }
+        }
+    }
+    return out;
+}
+
+// returns f(g(x))
+template <typename ValueType>
+Polynomial<ValueType> operator&(const Polynomial<ValueType>& f, const Polynomial<ValueType>& g) {
+    // divide and conquer over the halves of f with the precomputed g^(2^i):
+    // the multiplications are balanced, so fast multiplication pays off
+    size_t size = 1;
+    while (static_cast<int>(size) <= f.Degree()) {
+        size *= 2;
+    }
+    std::vector<Polynomial<ValueType>> g_pows{g};
+    while ((size_t(1) << g_pows.size()) < size) {
+        g_pows.push_back(g_pows.back() * g_pows.back());
+    }
+    return polynomial_detail::compose_part(f, 0, size, g, g_pows);
+}
+
+template <typename ValueType>
+Polynomial<ValueType> x_pow(size_t pow) {
+    std::vector<ValueType> vec(pow + 1, ValueType(0));
+    vec[pow] = ValueType(1);
+    return Polynomial(std::move(vec));
+}
+
+template <typename ValueType>
+Polynomial<ValueType> derivative(const Polynomial<ValueType>& poly) {
+    if (poly.Degree() <= 0) {
+        return Polynomial<ValueType>(ValueType(0));
+    }
+    std::vector<ValueType> res(poly.begin() + 1, poly.end());
+    for (size_t deg = 1; deg < res.size(); ++deg) {
+        res[deg] *= ValueType(static_cast<int>(deg + 1));
+    }
+    return Polynomial<ValueType>(std::move(res));
+}
+
+template <typename ValueType>
+Polynomial<ValueType> interpolate(const std::vector<ValueType>& xs, const std::vector<ValueType>& ys) {
+    static_assert(polynomial_detail::is_field<ValueType>::value,
+                  "interpolate needs invertible coefficients");
+    using namespace polynomial_detail;
+
+    const size_t n = xs.size();
+    if (n <= MULTIPOINT_THRESHOLD ||
+        std::is_floating_point<ValueType>::value || is_complex<ValueType>::value) {
+        return newton_interpolate(xs, ys);
+    }
+
+    // Lagrange: f = sum ys[i] / M'(xs[i]) * M / (x - xs[i]), where M = prod (x - xs[i])
+    std::vector<Polynomial<ValueType>> tree(4 * n);
+    build_subproduct_tree(xs.data(), 0, n, 1, tree);
+    std::vector<ValueType> weights(n);
+    evaluate_descent(derivative(tree[1]), xs.data(), 0, n, 1, tree, weights.data());
+    for (size_t i = 0; i < n; ++i) {
+        weights[i] = ys[i] / weights[i];
+    }
+    return combine_interpolation(xs.data(), weights.data(), 0, n, 1, tree);
+}
+
+template <typename ValueType>
+std::pair<Polynomial<ValueType>, Polynomial<ValueType>> divmod(
+        const Polynomial<ValueType>& dividend, const Polynomial<ValueType>& divisor) {
+    const int DEG = dividend.Degree(), DDEG = divisor.Degree();
+    if (DEG < DDEG) {
+        return {Polynomial<ValueType>(ValueType(0)), dividend};
+    }
+
+    const size_t qsize = DEG - DDEG + 1;
+    if constexpr (polynomial_detail::is_field<ValueType>::value) {
+        if (std::min<size_t>(qsize, DDEG + 1) > polynomial_detail::NEWTON_DIVISION_THRESHOLD) {
+            Polynomial<ValueType> quotient(polynomial_detail::newton_divide(
+                    &dividend[0], DEG + 1, &divisor[0], DDEG + 1));
+            // the remainder has degree < DDEG: only the lowest coefficients of the product matter
+            std::vector<ValueType> product = polynomial_detail::multiply(
+                    &quotient[0], std::min(quotient.Degree() + 1, DDEG), &divisor[0], DDEG);
+            std::vector<ValueType> remainder(dividend.begin(), dividend.begin() + DDEG);
+            for (size_t deg = 0; deg < remainder.size() && deg < product.size(); ++deg) {
+                remainder[deg] -= product[deg];
+            }
+            return {std::move(quotient), Polynomial<ValueType>(std::move(remainder))};
+        }
+    }
+
+    std::vector<ValueType> remainder(dividend.begin(), dividend.end());
+    Polynomial<ValueType> quotient(polynomial_detail::naive_divmod(remainder, &divisor[0], DDEG + 1));
+    return {std::move(quotient), Polynomial<ValueType>(std::move(remainder))};
+}
+
+template <typename ValueType>
+Polynomial<ValueType> operator/(Polynomial<ValueType> dividend,
+                                const Polynomial<ValueType>& divisor) {
+    return divmod(dividend, divisor).first;
+}
+
+template <typename ValueType>
+Polynomial<ValueType> operator%(const Polynomial<ValueType>& dividend,
+                                const Polynomial<ValueType>& divisor) {
+    return divmod(dividend, divisor).second;
+}
+
+template <typename ValueType>
+Polynomial<ValueType> compose_mod_baby_giant(const Polynomial<ValueType>& f, const Polynomial<ValueType>& g,
+                                             const Polynomial<ValueType>& h) {
+    // f = sum F_j * x^(k * j) with deg F_j < k,
+    // baby steps: g^i mod h for i < k, giant step: g^k mod h
+    size_t k = 1;
+    while (k * k < static_cast<size_t>(f.Degree() + 1)) {
+        ++k;
+    }
+    std::vector<Polynomial<ValueType>> baby{Polynomial<ValueType>(ValueType(1)) % h, g % h};
+    while (baby.size() <= k) {
+        baby.push_back(baby.back() * baby[1] % h);
+    }
+    const Polynomial<ValueType> giant = baby[k];
+
+    // Horner's rule in g^k: res = res * g^k + F_j(g)
+    Polynomial<ValueType> res(ValueType(0));
+    for (size_t block = (f.Degree() + k) / k; block-- > 0; ) {
+        Polynomial<ValueType> part(ValueType(0));
+        for (size_t i = 0; i < k; ++i) {
+            if (f[block * k + i] != ValueType(0)) {
+                part += f[block * k + i] * baby[i];
+            }
+        }
+        res = (res * giant + part) % h;
+    }
+    return res;
+}
+
+template <typename ValueType>
+PolyModulus<ValueType>::PolyModulus(const Polynomial<ValueType>& f): modulus(f.begin(), f.end()) {
+    using namespace polynomial_detail;
+
+    const int n = f.Degree();
+    if (n <= 0) {
+        throw std::domain_error("PolyModulus: the modulus must have a positive degree");
+    }
+    if (!is_field<ValueType>::value && f[n] != ValueType(1) && f[n] != ValueType(-1)) {
+        throw std::domain_error("PolyModulus: the leading coefficient must be 1 or -1 for non-field coefficients");
+    }
+    if constexpr (is_field<ValueType>::value) {
+        const ValueType inv_lead = ValueType(1) / f[n];
+        for (auto& coeff : modulus) {
+            coeff *= inv_lead;
+        }
+        std::vector<ValueType> rev_modulus(modulus.rbegin(), modulus.rend());
+        rev_inv = series_inverse(rev_modulus.data(), modulus.size(), n);
+    }
+    if constexpr (is_modint<ValueType>::value) {
+        const size_t long_size = fft::transform_size(2 * n - 1), short_size = fft::transform_size(n);
+        if (static_cast<size_t>(n) > NEWTON_DIVISION_THRESHOLD &&
+            long_size <= fft::max_ntt_size<ValueType::modulus>()) {
+            rev_inv_transform = rev_inv;
+            rev_inv_transform.resize(long_size, ValueType(0));
+            fft::ntt(rev_inv_transform, false);
+            modulus_transform.assign(short_size, ValueType(0));
+            for (size_t deg = 0; deg < modulus.size(); ++deg) {
+                modulus_transform[deg % short_size] += modulus[deg];
+            }
+            fft::ntt(modulus_transform, false);
+        }
+    }
+}
+
+template <typename ValueType>
+std::vector<ValueType> PolyModulus<ValueType>::reduce_short(std::vector<ValueType> a) const {
+    using namespace polynomial_detail;
+
+    const size_t msize = modulus.size(), rsize = msize - 1;
+    if (a.size() < msize) {
+        return a;
+    }
+    if constexpr (is_modint<ValueType>::value) {
+        const size_t qsize = a.size() - rsize;
+        if (!rev_inv_transform.empty() && qsize > NEWTON_DIVISION_THRESHOLD) {
+            // rev(q) = rev(a) * rev_inv mod x^qsize, the transform is long enough for the whole product
+            std::vector<ValueType> quotient(a.rbegin(), a.rbegin() + qsize);
+            quotient.resize(rev_inv_transform.size(), ValueType(0));
+            fft::ntt(quotient, false);
+            for (size_t i = 0; i < quotient.size(); ++i) {
+                quotient[i] *= rev_inv_transform[i];
+            }
+            fft::ntt(quotient, true);
+            quotient.resize(qsize);
+            std::reverse(quotient.begin(), quotient.end());
+
+            // a - q * modulus has less than rsize <= m coefficients,
+            // so it equals (a - q * modulus) mod x^m - 1
+            const size_t m = modulus_transform.size();
+            quotient.resize(m, ValueType(0));
+            fft::ntt(quotient, false);
+            for (size_t i = 0; i < m; ++i) {
+                quotient[i] *= modulus_transform[i];
+            }
+            fft::ntt(quotient, true);
+            for (size_t deg = m; deg < a.size(); ++deg) {
+                a[deg % m] += a[deg];
+            }
+            a.resize(rsize);
+            for (size_t deg = 0; deg < rsize; ++deg) {
+                a[deg] -= quotient[deg];
+            }
+            return a;
+        }
+    }
+    if constexpr (is_field<ValueType>::value) {
+        return reduce_with_inverse(std::move(a), modulus.data(), msize, rev_inv);
+    } else {
+        naive_divmod(a, modulus.data(), msize);
+        a.resize(rsize);
+        return a;
+    }
+}
+
+template <typename ValueType>
+std::vector<ValueType> PolyModulus<ValueType>::reduce_vector(std::vector<ValueType> a) const {
+    const size_t n = modulus.size() - 1;
+    if constexpr (polynomial_detail::is_field<ValueType>::value) {
+        // rev_inv covers quotients of up to n coefficients: longer inputs are reduced
+        // from the top, a window of 2n - 1 coefficients at a time, n - 1 of them vanishing per step;
+        // small moduli divide step by step anyway
+        while (a.size() > 2 * n - 1 && n + 1 > polynomial_detail::NEWTON_DIVISION_THRESHOLD) {
+            const size_t first = a.size() - (2 * n - 1);
+            std::vector<ValueType> window = reduce_short(std::vector<ValueType>(a.begin() + first, a.end()));
+            a.resize(first);
+            a.insert(a.end(), window.begin(), window.end());
+        }
+    }
+    return reduce_short(std::move(a));
+}
+
+template <typename ValueType>
+int PolyModulus<ValueType>::Degree() const {
+    return static_cast<int>(modulus.size()) - 1;
+}
+
+template <typename ValueType>
+Polynomial<ValueType> PolyModulus<ValueType>::Modulus() const {
+    return Polynomial<ValueType>(modulus);
+}
+
+template <typename ValueType>
+Polynomial<ValueType> PolyModulus<ValueType>::reduce(const Polynomial<ValueType>& a) const {
+    return Polynomial<ValueType>(reduce_vector(std::vector<ValueType>(a.begin(), a.end())));
+}
+
+template <typename ValueType>
+Polynomial<ValueType> PolyModulus<ValueType>::mulmod(const Polynomial<ValueType>& a,
+                                                     const Polynomial<ValueType>& b) const {
+    if (a.Degree() == -1 || b.Degree() == -1) {
+        return Polynomial<ValueType>(ValueType(0));
+    }
+    return Polynomial<ValueType>(reduce_vector(polynomial_detail::multiply(
+            &a[0], a.Degree() + 1, &b[0], b.Degree() + 1)));
+}
+
+template <typename ValueType>
+Polynomial<ValueType> PolyModulus<ValueType>::sqrmod(const Polynomial<ValueType>& a) const {
+    using namespace polynomial_detail;
+
+    const size_t size = a.Degree() + 1;
+    if (size == 0) {
+        return Polynomial<ValueType>(ValueType(0));
+    }
+    if constexpr (is_modint<ValueType>::value) {
+        // a single forward transform serves both factors
+        const size_t n = fft::transform_size(2 * size - 1);
+        if (size > NTT_MULTIPLY_THRESHOLD && n <= fft::max_ntt_size<ValueType::modulus>()) {
+            std::vector<ValueType> square(a.begin(), a.end());
+            square.resize(n, ValueType(0));
+            fft::ntt(square, false);
+            for (auto& value : square) {
+                value *= value;
+            }
+            fft::ntt(square, true);
+            square.resize(2 * size - 1);
+            return Polynomial<ValueType>(reduce_vector(std::move(square)));
+        }
+    }
+    return Polynomial<ValueType>(reduce_vector(multiply(&a[0], size, &a[0], size)));
+}
+
+template <typename ValueType>
+Polynomial<ValueType> PolyModulus<ValueType>::powmod(const Polynomial<ValueType>& base,
+                                                     unsigned long long exp) const {
+    if (exp == 0) {
+        return Polynomial<ValueType>(ValueType(1));
+    }
+
+    // the multiplication by x is a shift followed by a single reduction step
+    const bool base_is_x = base.Degree() == 1 && base[0] == ValueType(0) && base[1] == ValueType(1);
+    const Polynomial<ValueType> reduced_base = reduce(base);
+    if (reduced_base.Degree() == -1) {
+        return reduced_base;
+    }
+    Polynomial<ValueType> res(ValueType(1));
+    for (int bit = 63 - __builtin_clzll(exp); bit >= 0; --bit) {
+        res = sqrmod(res);
+        if (!((exp >> bit) & 1)) {
+            continue;
+        }
+        if (base_is_x) {
+            std::vector<ValueType> shifted{ValueType(0)};
+            shifted.insert(shifted.end(), res.begin(), res.end());
+            res = Polynomial<ValueType>(reduce_vector(std::move(shifted)));
+        } else {
+            res = mulmod(res, reduced_base);
+        }
+    }
+    return res;
+}
+
+template <typename ValueType>
+Polynomial<ValueType> powmod(const Polynomial<ValueType>& base, unsigned long long exp,
+                             const Polynomial<ValueType>& f) {
+    if (f.Degree() <= 0) {
+        return Polynomial<ValueType>(ValueType(0));
+    }
+    return PolyModulus<ValueType>(f).powmod(base, exp);
+}
+
+template <typename ValueType>
+Polynomial<ValueType> berlekamp_massey(const std::vector<ValueType>& sequence) {
+    static_assert(polynomial_detail::is_field<ValueType>::value,
+                  "berlekamp_massey needs invertible coefficients");
+    // connection polynomial conn: sum conn[j] * a_(i - j) = 0 for len <= i < the processed prefix,
+    // prev is the one before the last length change
+    std::vector<ValueType> conn{ValueType(1)}, prev{ValueType(1)};
+    ValueType prev_discrepancy(1);
+    size_t len = 0, shift = 1;
+    for (size_t i = 0; i < sequence.size(); ++i, ++shift) {
+        ValueType discrepancy = sequence[i];
+        for (size_t j = 1; j <= len && j < conn.size(); ++j) {
+            discrepancy += conn[j] * sequence[i - j];
+        }
+        if (discrepancy == ValueType(0)) {
+            continue;
+        }
+
+        const ValueType coeff = discrepancy / prev_discrepancy;
+        std::vector<ValueType> old = conn;
+        conn.resize(std::max(conn.size(), prev.size() + shift), ValueType(0));
+        for (size_t j = 0; j < prev.size(); ++j) {
+            conn[j + shift] -= coeff * prev[j];
+        }
+        if (2 * len <= i) {
+            len = i + 1 - len;
+            prev = std::move(old);
+            prev_discrepancy = discrepancy;
+            shift = 0;
+        }
+    }
+
+    // characteristic polynomial: x^len * conn(1 / x)
+    conn.resize(len + 1, ValueType(0));
+    std::reverse(conn.begin(), conn.end());
+    return Polynomial<ValueType>(std::move(conn));
+}
+
+template <typename ValueType>
+ValueType nth_term(const std::vector<ValueType>& initial,
+                   const Polynomial<ValueType>& characteristic, unsigned long long n) {
+    if (n < initial.size()) {
+        return initial[n];
+    }
+    const Polynomial<ValueType> rem = powmod(x_pow<ValueType>(1), n, characteristic);
+    ValueType res(0);
+    for (int deg = 0; deg <= rem.Degree(); ++deg) {
+        res += rem[deg] * initial[deg];
+    }
+    return res;
+}
+
+template <typename ValueType>
+ValueType nth_term(const std::vector<ValueType>& sequence, unsigned long long n) {
+    return nth_term(sequence, berlekamp_massey(sequence), n);
 }
 
+namespace polynomial_detail {
+
 template <typename ValueType>
-Polynomial<ValueType> x_pow(size_t pow) {
-    std::vector<ValueType> vec(pow + 1, ValueType(0));
-    vec[pow] = ValueType(1);
-    return Polynomial(vec);
+void horner_batch(const ValueType* coeffs, size_t size,
+                  const ValueType* points, size_t count, ValueType* out) {
+    if (size == 0) {
+        std::fill(out, out + count, ValueType(0));
+        return;
+    }
+    // a local accumulator cannot alias points or coeffs, so the inner loop vectorizes
+    ValueType acc[HORNER_BLOCK];
+    for (size_t first = 0; first < count; first += HORNER_BLOCK) {
+        const size_t block = std::min(count - first, HORNER_BLOCK);
+        const ValueType* block_points = points + first;
+        for (size_t j = 0; j < block; ++j) {
+            acc[j] = coeffs[size - 1];
+        }
+        for (size_t i = size - 1; i-- > 0; ) {
+            const ValueType coeff = coeffs[i];
+            for (size_t j = 0; j < block; ++j) {
+                acc[j] = acc[j] * block_points[j] + coeff;
+            }
+        }
+        std::copy(acc, acc + block, out + first);
+    }
+}
+
+#if defined(__AVX2__) && defined(__FMA__)
+inline void horner_batch(const double* coeffs, size_t size,
+                         const double* points, size_t count, double* out) {
+    const size_t LANES = 4, REGS = 8, BLOCK = LANES * REGS;
+    if (size == 0 || count < BLOCK) {
+        horner_batch<double>(coeffs, size, points, count, out);
+        return;
+    }
+
+    size_t first = 0;
+    for (; first + BLOCK <= count; first += BLOCK) {
+        __m256d acc[REGS];
+        for (size_t r = 0; r < REGS; ++r) {
+            acc[r] = _mm256_set1_pd(coeffs[size - 1]);
+        }
+        for (size_t i = size - 1; i-- > 0; ) {
+            const __m256d coeff = _mm256_set1_pd(coeffs[i]);
+            for (size_t r = 0; r < REGS; ++r) {
+                acc[r] = _mm256_fmadd_pd(acc[r], _mm256_loadu_pd(points + first + r * LANES), coeff);
+            }
+        }
+        for (size_t r = 0; r < REGS; ++r) {
+            _mm256_storeu_pd(out + first + r * LANES, acc[r]);
+        }
+    }
+    horner_batch<double>(coeffs, size, points + first, count - first, out + first);
+}
+
+inline void horner_batch(const float* coeffs, size_t size,
+                         const float* points, size_t count, float* out) {
+    const size_t LANES = 8, REGS = 8, BLOCK = LANES * REGS;
+    if (size == 0 || count < BLOCK) {
+        horner_batch<float>(coeffs, size, points, count, out);
+        return;
+    }
+
+    size_t first = 0;
+    for (; first + BLOCK <= count; first += BLOCK) {
+        __m256 acc[REGS];
+        for (size_t r = 0; r < REGS; ++r) {
+            acc[r] = _mm256_set1_ps(coeffs[size - 1]);
+        }
+        for (size_t i = size - 1; i-- > 0; ) {
+            const __m256 coeff = _mm256_set1_ps(coeffs[i]);
+            for (size_t r = 0; r < REGS; ++r) {
+                acc[r] = _mm256_fmadd_ps(acc[r], _mm256_loadu_ps(points + first + r * LANES), coeff);
+            }
+        }
+        for (size_t r = 0; r < REGS; ++r) {
+            _mm256_storeu_ps(out + first + r * LANES, acc[r]);
+        }
+    }
+    horner_batch<float>(coeffs, size, points + first, count - first, out + first);
 }
+#endif
 
 template <typename ValueType>
-Polynomial<ValueType> operator/(Polynomial<ValueType> dividend,
-                                const Polynomial<ValueType>& divisor) {
-    Polynomial<ValueType> res(ValueType(0));
-    if (dividend.Degree() < divisor.Degree()) {
+void build_subproduct_tree(const ValueType* points, size_t first, size_t last, size_t node,
+                           std::vector<Polynomial<ValueType>>& tree) {
+    if (last - first <= MULTIPOINT_THRESHOLD) {  // the descent stops here: product by linear factors
+        std::vector<ValueType> product{ValueType(1)};
+        for (size_t i = first; i < last; ++i) {
+            product.push_back(ValueType(0));
+            for (size_t deg = product.size() - 1; deg > 0; --deg) {
+                product[deg] = product[deg - 1] - points[i] * product[deg];
+            }
+            product[0] = -points[i] * product[0];
+        }
+        tree[node] = Polynomial<ValueType>(product);
+        return;
+    }
+
+    const size_t middle = first + (last - first) / 2;
+    build_subproduct_tree(points, first, middle, 2 * node, tree);
+    build_subproduct_tree(points, middle, last, 2 * node + 1, tree);
+    tree[node] = tree[2 * node] * tree[2 * node + 1];
+}
+
+template <typename ValueType>
+void evaluate_descent(const Polynomial<ValueType>& remainder, const ValueType* points,
+                      size_t first, size_t last, size_t node,
+                      const std::vector<Polynomial<ValueType>>& tree, ValueType* out) {
+    if (last - first <= MULTIPOINT_THRESHOLD) {
+        horner_batch(remainder.Degree() == -1 ? nullptr : &remainder[0], remainder.Degree() + 1,
+                     points + first, last - first, out + first);
+        return;
+    }
+
+    const size_t middle = first + (last - first) / 2;
+    for (size_t child : {2 * node, 2 * node + 1}) {
+        const size_t child_first = (child == 2 * node ? first : middle);
+        const size_t child_last = (child == 2 * node ? middle : last);
+        if (remainder.Degree() >= tree[child].Degree()) {
+            evaluate_descent(remainder % tree[child], points, child_first, child_last,
+                             child, tree, out);
+        } else {
+            evaluate_descent(remainder, points, child_first, child_last, child, tree, out);
+        }
+    }
+}
+
+template <typename ValueType>
+Polynomial<ValueType> compose_part(const Polynomial<ValueType>& f, size_t first, size_t size,
+                                   const Polynomial<ValueType>& g,
+                                   const std::vector<Polynomial<ValueType>>& g_pows) {
+    if (size <= COMPOSITION_THRESHOLD) {
+        Polynomial<ValueType> res(ValueType(0));
+        for (size_t deg = first + size; deg-- > first; ) {
+            res = res * g + f[deg];
+        }
         return res;
     }
 
-    for (int cur_pow = dividend.Degree() - divisor.Degree(); cur_pow >= 0; ) {
-        Polynomial<ValueType> cur_mult =
-                (dividend[dividend.Degree()] / divisor[divisor.Degree()])
-                * x_pow<ValueType>(cur_pow);
+    // f_part = low + x^half * high, so f_part(g) = low(g) + g^half * high(g)
+    const size_t half = size / 2;
+    size_t level = 0;
+    while ((size_t(1) << level) < half) {
+        ++level;
+    }
+    Polynomial<ValueType> res = compose_part(f, first, half, g, g_pows);
+    if (static_cast<int>(first + half) <= f.Degree()) {
+        res += compose_part(f, first + half, half, g, g_pows) * g_pows[level];
+    }
+    return res;
+}
 
-        if (cur_mult == Polynomial<ValueType>(ValueType(0))) {
-            break;
+template <typename ValueType>
+Polynomial<ValueType> newton_interpolate(const std::vector<ValueType>& xs,
+                                         const std::vector<ValueType>& ys) {
+    const size_t n = xs.size();
+    std::vector<ValueType> diffs(ys);
+    for (size_t step = 1; step < n; ++step) {
+        for (size_t i = n - 1; i >= step; --i) {
+            diffs[i] = (diffs[i] - diffs[i - 1]) / (xs[i] - xs[i - step]);
         }
+    }
 
-        dividend -= cur_mult * divisor;
-        res += cur_mult;
+    // Horner's rule for the Newton form: res = diffs[i] + (x - xs[i]) * res
+    std::vector<ValueType> res;
+    for (size_t i = n; i-- > 0; ) {
+        res.push_back(ValueType(0));
+        for (size_t deg = res.size() - 1; deg > 0; --deg) {
+            res[deg] = res[deg - 1] - xs[i] * res[deg];
+        }
+        res[0] = diffs[i] - xs[i] * res[0];
+    }
+    return Polynomial<ValueType>(std::move(res));
+}
 
-        cur_pow = dividend.Degree() - divisor.Degree();
+template <typename ValueType>
+Polynomial<ValueType> combine_interpolation(const ValueType* points, const ValueType* weights,
+                                            size_t first, size_t last, size_t node,
+                                            const std::vector<Polynomial<ValueType>>& tree) {
+    if (last - first <= MULTIPOINT_THRESHOLD) {  // a leaf of the tree built by build_subproduct_tree
+        std::vector<ValueType> res(last - first, ValueType(0)), quotient(last - first);
+        for (size_t i = first; i < last; ++i) {
+            // synthetic division of tree[node] by (x - points[i])
+            ValueType carry(0);
+            for (size_t deg = last - first; deg-- > 0; ) {
+                carry = tree[node][deg + 1] + carry * points[i];
+                quotient[deg] = carry;
+            }
+            for (size_t deg = 0; deg < res.size(); ++deg) {
+                res[deg] += weights[i] * quotient[deg];
+            }
+        }
+        return Polynomial<ValueType>(std::move(res));
     }
 
+    const size_t middle = first + (last - first) / 2;
+    return combine_interpolation(points, weights, first, middle, 2 * node, tree) * tree[2 * node + 1] +
+           combine_interpolation(points, weights, middle, last, 2 * node + 1, tree) * tree[2 * node];
+}
+
+template <typename ValueType>
+TransitionMatrix<ValueType>::TransitionMatrix():
+        a00(ValueType(1)), a01(ValueType(0)), a10(ValueType(0)), a11(ValueType(1)) {}
+
+template <typename ValueType>
+TransitionMatrix<ValueType> operator*(const TransitionMatrix<ValueType>& lhs,
+                                      const TransitionMatrix<ValueType>& rhs) {
+    TransitionMatrix<ValueType> res;
+    res.a00 = lhs.a00 * rhs.a00 + lhs.a01 * rhs.a10;
+    res.a01 = lhs.a00 * rhs.a01 + lhs.a01 * rhs.a11;
+    res.a10 = lhs.a10 * rhs.a00 + lhs.a11 * rhs.a10;
+    res.a11 = lhs.a10 * rhs.a01 + lhs.a11 * rhs.a11;
     return res;
 }
 
 template <typename ValueType>
-Polynomial<ValueType> operator%(const Polynomial<ValueType>& dividend,
-                                const Polynomial<ValueType>& divisor) {
-    return dividend - (dividend / divisor) * divisor;
+void apply(const TransitionMatrix<ValueType>& matrix,
+           Polynomial<ValueType>& a, Polynomial<ValueType>& b) {
+    Polynomial<ValueType> new_a = matrix.a00 * a + matrix.a01 * b;
+    b = matrix.a10 * a + matrix.a11 * b;
+    a = new_a;
+}
+
+template <typename ValueType>
+TransitionMatrix<ValueType> euclid_step(Polynomial<ValueType>& a, Polynomial<ValueType>& b) {
+    auto [quotient, remainder] = divmod(a, b);
+    a = b;
+    b = remainder;
+
+    // (a, b) -> (b, a - q * b)
+    TransitionMatrix<ValueType> step;
+    step.a00 = Polynomial<ValueType>(ValueType(0));
+    step.a01 = Polynomial<ValueType>(ValueType(1));
+    step.a10 = Polynomial<ValueType>(ValueType(1));
+    step.a11 = -quotient;
+    return step;
+}
+
+template <typename ValueType>
+Polynomial<ValueType> div_x_pow(const Polynomial<ValueType>& poly, int k) {
+    if (poly.Degree() < k) {
+        return Polynomial<ValueType>(ValueType(0));
+    }
+    return Polynomial<ValueType>(poly.begin() + k, poly.end());
+}
+
+template <typename ValueType>
+TransitionMatrix<ValueType> half_gcd(const Polynomial<ValueType>& a, const Polynomial<ValueType>& b) {
+    const int m = (a.Degree() + 1) / 2;
+    if (b.Degree() < m) {
+        return TransitionMatrix<ValueType>();
+    }
+
+    if (a.Degree() < HALF_GCD_THRESHOLD) {
+        TransitionMatrix<ValueType> res;
+        Polynomial<ValueType> c = a, d = b;
+        while (d.Degree() >= m) {
+            res = euclid_step(c, d) * res;
+        }
+        return res;
+    }
+
+    // the quotients of the high halves coincide with the first half of the quotients of a and b
+    TransitionMatrix<ValueType> res = half_gcd(div_x_pow(a, m), div_x_pow(b, m));
+    Polynomial<ValueType> c = a, d = b;
+    apply(res, c, d);
+    if (d.Degree() < m) {
+        return res;
+    }
+
+    res = euclid_step(c, d) * res;
+    if (d.Degree() < m) {
+        return res;
+    }
+
+    const int k = 2 * m - c.Degree();
+    return half_gcd(div_x_pow(c, k), div_x_pow(d, k)) * res;
+}
+
+template <typename ValueType>
+void reduce_to_gcd(Polynomial<ValueType>& a, Polynomial<ValueType>& b,
+                   TransitionMatrix<ValueType>* matrix) {
+    while (b.Degree() != -1) {
+        if (a.Degree() > b.Degree() && a.Degree() >= HALF_GCD_THRESHOLD) {
+            TransitionMatrix<ValueType> reduction = half_gcd(a, b);
+            apply(reduction, a, b);
+            if (matrix != nullptr) {
+                *matrix = reduction * *matrix;
+            }
+            if (b.Degree() == -1) {
+                break;
+            }
+        }
+
+        TransitionMatrix<ValueType> step = euclid_step(a, b);
+        if (matrix != nullptr) {
+            *matrix = step * *matrix;
+        }
+    }
 }
 
+}  // namespace polynomial_detail
+
 template <typename ValueType>
 Polynomial<ValueType> operator,(Polynomial<ValueType> a, Polynomial<ValueType> b) {
-    while (a.Degree() != -1 && b.Degree() != -1) {
-        if (a.Degree() > b.Degree() ||
-            (a.Degree() == b.Degree() && a[a.Degree()] > b[b.Degree()])) {
-            a = a % b;
+    if constexpr (polynomial_detail::is_field<ValueType>::value) {
+        if (a.Degree() < b.Degree()) {
+            std::swap(a, b);
+        }
+        polynomial_detail::reduce_to_gcd<ValueType>(a, b, nullptr);
+        return a / Polynomial(a[a.Degree()]);
+    } else {
+        while (a.Degree() != -1 && b.Degree() != -1) {
+            if (a.Degree() > b.Degree() ||
+                (a.Degree() == b.Degree() && a[a.Degree()] > b[b.Degree()])) {
+                a = a % b;
+            } else {
+                b = b % a;
+            }
+        }
+        Polynomial<ValueType> res = a + b;
+        return res / Polynomial(res[res.Degree()]);
+    }
+}
+
+template <typename ValueType>
+std::tuple<Polynomial<ValueType>, Polynomial<ValueType>, Polynomial<ValueType>> extended_gcd(
+        const Polynomial<ValueType>& a, const Polynomial<ValueType>& b) {
+    static_assert(polynomial_detail::is_field<ValueType>::value,
+                  "extended_gcd needs invertible coefficients");
+
+    Polynomial<ValueType> g = a, h = b;
+    polynomial_detail::TransitionMatrix<ValueType> matrix;
+    if (g.Degree() < h.Degree()) {
+        std::swap(g, h);
+        std::swap(matrix.a00, matrix.a01);
+        std::swap(matrix.a10, matrix.a11);
+    }
+    polynomial_detail::reduce_to_gcd(g, h, &matrix);
+
+    if (g.Degree() == -1) {  // a = b = 0
+        return {g, matrix.a00, matrix.a01};
+    }
+    // g = a00 * a + a01 * b, made monic
+    const ValueType inv_lead = ValueType(1) / g[g.Degree()];
+    return {g * inv_lead, matrix.a00 * inv_lead, matrix.a01 * inv_lead};
+}
+
+namespace polynomial_detail {
+
+inline uint32_t power_mod(uint32_t a, uint64_t exp, uint32_t mod) {
+    uint64_t res = 1, base = a % mod;
+    for (; exp; exp >>= 1) {
+        if (exp & 1) {
+            res = res * base % mod;
+        }
+        base = base * base % mod;
+    }
+    return static_cast<uint32_t>(res);
+}
+
+inline bool is_prime(uint32_t n) {
+    if (n < 2) {
+        return false;
+    }
+    for (uint32_t p : {2u, 3u, 5u, 7u, 61u}) {
+        if (n % p == 0) {
+            return n == p;
+        }
+    }
+    // n - 1 = d * 2^s with odd d
+    uint32_t d = n - 1;
+    int s = 0;
+    for (; d % 2 == 0; d /= 2) {
+        ++s;
+    }
+    for (uint32_t base : {2u, 7u, 61u}) {
+        uint64_t x = power_mod(base, d, n);
+        if (x == 1 || x == n - 1) {
+            continue;
+        }
+        int i = 1;
+        for (; i < s; ++i) {
+            x = x * x % n;
+            if (x == n - 1) {
+                break;
+            }
+        }
+        if (i == s) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline std::vector<uint32_t> gcd_mod(std::vector<uint32_t> a, std::vector<uint32_t> b, uint32_t mod) {
+    while (!b.empty()) {
+        // a %= b
+        const uint64_t inv_lead = power_mod(b.back(), mod - 2, mod);
+        while (a.size() >= b.size()) {
+            const uint64_t quotient = a.back() * inv_lead % mod;
+            const size_t shift = a.size() - b.size();
+            for (size_t i = 0; i < b.size(); ++i) {
+                a[shift + i] = static_cast<uint32_t>((a[shift + i] + (mod - quotient) * b[i]) % mod);
+            }
+            while (!a.empty() && a.back() == 0) {
+                a.pop_back();
+            }
+        }
+        std::swap(a, b);
+    }
+    const uint64_t inv_lead = power_mod(a.back(), mod - 2, mod);
+    for (uint32_t& coeff : a) {
+        coeff = static_cast<uint32_t>(coeff * inv_lead % mod);
+    }
+    return a;
+}
+
+template <typename BigInteger>
+BigInteger gcd_value(BigInteger a, BigInteger b) {
+    while (b != BigInteger(0)) {
+        BigInteger rem = a % b;
+        a = b;
+        b = rem;
+    }
+    return (a < BigInteger(0) ? -a : a);
+}
+
+template <typename BigInteger>
+BigInteger content(const std::vector<BigInteger>& coeffs) {
+    BigInteger res(0);
+    for (const BigInteger& coeff : coeffs) {
+        res = gcd_value(res, coeff);
+    }
+    return res;
+}
+
+template <typename BigInteger>
+bool divides(const std::vector<BigInteger>& divisor, const std::vector<BigInteger>& poly) {
+    const int n = static_cast<int>(poly.size()) - 1, m = static_cast<int>(divisor.size()) - 1;
+    if (n < m) {
+        return false;
+    }
+    const BigInteger ZERO(0);
+    if (divisor[0] != ZERO && poly[0] % divisor[0] != ZERO) {  // cheap rejection by the constant terms
+        return false;
+    }
+
+    std::vector<BigInteger> rem = poly;
+    const BigInteger& lead = divisor[m];
+    for (int i = n; i >= m; --i) {
+        if (rem[i] % lead != ZERO) {
+            return false;
+        }
+        const BigInteger quotient = rem[i] / lead;
+        for (int j = 0; j < m; ++j) {
+            rem[i - m + j] -= quotient * divisor[j];
+        }
+    }
+    for (int i = 0; i < m; ++i) {
+        if (rem[i] != ZERO) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace polynomial_detail
+
+template <typename BigInteger, typename ValueType>
+Polynomial<ValueType> integer_gcd(const Polynomial<ValueType>& a, const Polynomial<ValueType>& b) {
+    if (a.Degree() == -1 || b.Degree() == -1) {
+        const Polynomial<ValueType>& res = (a.Degree() == -1 ? b : a);
+        return res.Degree() != -1 && res[res.Degree()] < ValueType(0) ? -res : res;
+    }
+
+    const BigInteger ZERO(0);
+    std::vector<BigInteger> a_coeffs(a.begin(), a.end()), b_coeffs(b.begin(), b.end());
+    const BigInteger a_content = polynomial_detail::content(a_coeffs);
+    const BigInteger b_content = polynomial_detail::content(b_coeffs);
+    for (BigInteger& coeff : a_coeffs) {
+        coeff = coeff / a_content;
+    }
+    for (BigInteger& coeff : b_coeffs) {
+        coeff = coeff / b_content;
+    }
+    const BigInteger lead = polynomial_detail::gcd_value(a_coeffs.back(), b_coeffs.back());
+
+    // Mignotte: a factor of f of degree k has coefficients at most 2^k * ||f||_1 by absolute value,
+    // the image below is the gcd times lead / (its leading coefficient), a divisor of lead
+    BigInteger a_norm(0), b_norm(0);
+    for (const BigInteger& coeff : a_coeffs) {
+        a_norm += (coeff < ZERO ? -coeff : coeff);
+    }
+    for (const BigInteger& coeff : b_coeffs) {
+        b_norm += (coeff < ZERO ? -coeff : coeff);
+    }
+    BigInteger bound = lead * (a_norm < b_norm ? a_norm : b_norm);
+    for (int i = std::min(a.Degree(), b.Degree()); i > 0; --i) {
+        bound += bound;
+    }
+
+    // the gcd scaled to the leading coefficient lead, modulo the product of the primes used so far,
+    // with coefficients in (-modulus / 2, modulus / 2]
+    std::vector<BigInteger> image;
+    BigInteger modulus(1);
+    int degree = -1;  // no prime used yet
+    std::vector<BigInteger> res;
+    for (uint32_t prime = (1u << 31) - 1; res.empty(); --prime) {
+        if (prime < 3) {
+            throw std::overflow_error("integer_gcd: ran out of primes below 2^31");
+        }
+        if (!polynomial_detail::is_prime(prime)) {
+            continue;
+        }
+        const BigInteger big_prime(static_cast<long long>(prime));
+        auto reduce = [&big_prime, prime](const BigInteger& value) {
+            const long long rem = static_cast<long long>(value % big_prime);
+            return static_cast<uint32_t>(rem < 0 ? rem + prime : rem);
+        };
+        std::vector<uint32_t> a_mod(a_coeffs.size()), b_mod(b_coeffs.size());
+        std::transform(a_coeffs.begin(), a_coeffs.end(), a_mod.begin(), reduce);
+        std::transform(b_coeffs.begin(), b_coeffs.end(), b_mod.begin(), reduce);
+        if (a_mod.back() == 0 || b_mod.back() == 0) {
+            continue;
+        }
+
+        const std::vector<uint32_t> g = polynomial_detail::gcd_mod(std::move(a_mod), std::move(b_mod), prime);
+        const int g_degree = static_cast<int>(g.size()) - 1;
+        if (g_degree == 0) {  // coprime primitive parts
+            res.push_back(BigInteger(1));
+            break;
+        }
+        if (degree != -1 && g_degree > degree) {  // prime divides the resultant of a / gcd and b / gcd
+            continue;
+        }
+        if (degree == -1 || g_degree < degree) {  // all the previous primes were like that
+            image.assign(g_degree + 1, ZERO);
+            modulus = BigInteger(1);
+            degree = g_degree;
+        }
+
+        // CRT: x = c + modulus * t with t = (g_i * lead - c) / modulus mod prime
+        const uint64_t lead_mod = reduce(lead);
+        const uint64_t inv_modulus = polynomial_detail::power_mod(reduce(modulus), prime - 2, prime);
+        const BigInteger old_modulus = modulus;
+        modulus = modulus * big_prime;
+        bool changed = false;
+        for (int i = 0; i <= degree; ++i) {
+            const uint64_t t = (g[i] * lead_mod % prime + prime - reduce(image[i])) % prime * inv_modulus % prime;
+            if (t != 0) {
+                image[i] += old_modulus * BigInteger(static_cast<long long>(t));
+                if (modulus < image[i] + image[i]) {
+                    image[i] -= modulus;
+                }
+                changed = true;
+            }
+        }
+        // the image is certainly complete once the modulus passes 2 * bound, and likely when it stops changing
+        if (changed && !(bound + bound < modulus)) {
+            continue;
+        }
+
+        std::vector<BigInteger> candidate = image;
+        BigInteger common = polynomial_detail::content(candidate);
+        if (candidate[degree] < ZERO) {
+            common = -common;
+        }
+        for (BigInteger& coeff : candidate) {
+            coeff = coeff / common;
+        }
+        // fails as long as all the primes in the image had a too high degree of the gcd
+        if (polynomial_detail::divides(candidate, a_coeffs) && polynomial_detail::divides(candidate, b_coeffs)) {
+            res = std::move(candidate);
+        }
+    }
+
+    // a factor of a may still have larger coefficients than a
+    const BigInteger common = polynomial_detail::gcd_value(a_content, b_content);
+    std::vector<ValueType> coeffs(res.size());
+    for (size_t i = 0; i < res.size(); ++i) {
+        const BigInteger coeff = res[i] * common;
+        if constexpr (std::is_same<ValueType, BigInteger>::value) {
+            coeffs[i] = coeff;
+        } else {
+            if (coeff < BigInteger(std::numeric_limits<ValueType>::min()) ||
+                BigInteger(std::numeric_limits<ValueType>::max()) < coeff) {
+                throw std::overflow_error("integer_gcd: the gcd coefficients do not fit the coefficient type");
+            }
+            coeffs[i] = static_cast<ValueType>(coeff);
+        }
+    }
+    return Polynomial<ValueType>(std::move(coeffs));
+}
+
+namespace polynomial_detail {
+
+template <typename ValueType>
+void split_roots(const Polynomial<ValueType>& g, std::mt19937_64& rng, std::vector<ValueType>& roots) {
+    if (g.Degree() <= 0) {
+        return;
+    }
+    if (g.Degree() == 1) {
+        roots.push_back(-g[0] / g[1]);
+        return;
+    }
+
+    const uint32_t p = ValueType::modulus;
+    const PolyModulus<ValueType> modulus(g);  // shared by the attempts
+    while (true) {
+        const Polynomial<ValueType> shifted(std::vector<ValueType>{
+                ValueType(static_cast<long long>(rng() % p)), ValueType(1)});
+        Polynomial<ValueType> h = (g, modulus.powmod(shifted, (p - 1) / 2) - ValueType(1));
+        if (h.Degree() > 0 && h.Degree() < g.Degree()) {
+            split_roots(h, rng, roots);
+            split_roots(g / h, rng, roots);
+            return;
+        }
+    }
+}
+
+}  // namespace polynomial_detail
+
+template <typename ValueType>
+std::vector<ValueType> find_roots(const Polynomial<ValueType>& f) {
+    static_assert(polynomial_detail::is_modint<ValueType>::value,
+                  "find_roots works over ModInt coefficients");
+    if (f.Degree() == -1) {
+        throw std::domain_error("find_roots: every element is a root of the zero polynomial");
+    }
+
+    std::vector<ValueType> roots;
+    const uint32_t p = ValueType::modulus;
+    if (p == 2) {  // no splitting exponent (p - 1) / 2, but only two candidates
+        for (uint32_t value = 0; value < p; ++value) {
+            if (f(ValueType(value)) == ValueType(0)) {
+                roots.push_back(ValueType(value));
+            }
+        }
+        return roots;
+    }
+
+    // the product of x - r over the distinct roots r: gcd(f, x^p - x)
+    const Polynomial<ValueType> x = x_pow<ValueType>(1);
+    const Polynomial<ValueType> linear = (f, powmod(x, p, f) - x);
+
+    std::mt19937_64 rng(f.Degree());
+    polynomial_detail::split_roots(linear, rng, roots);
+    std::sort(roots.begin(), roots.end(), [](const ValueType& lhs, const ValueType& rhs) {
+        return lhs.value() < rhs.value();
+    });
+    return roots;
+}
+
+template <typename ValueType>
+std::vector<std::pair<Polynomial<ValueType>, int>> distinct_degree_factorization(Polynomial<ValueType> f) {
+    static_assert(polynomial_detail::is_modint<ValueType>::value,
+                  "distinct_degree_factorization works over ModInt coefficients");
+    std::vector<std::pair<Polynomial<ValueType>, int>> res;
+    if (f.Degree() <= 0) {
+        return res;
+    }
+    f *= ValueType(1) / f[f.Degree()];
+
+    // x^(p^d) - x is the product of all the monic irreducible polynomials of degrees dividing d,
+    // the ones of smaller degrees have been divided out of f already
+    const Polynomial<ValueType> x = x_pow<ValueType>(1);
+    Polynomial<ValueType> frobenius = x;  // x^(p^d) mod f
+    PolyModulus<ValueType> modulus(f);  // rebuilt when f shrinks
+    for (int d = 1; 2 * d <= f.Degree(); ++d) {
+        frobenius = modulus.powmod(frobenius, ValueType::modulus);
+        Polynomial<ValueType> g = (f, frobenius - x);
+        if (g.Degree() > 0) {
+            f = f / g;
+            res.emplace_back(std::move(g), d);
+            if (f.Degree() <= 0) {
+                break;
+            }
+            modulus = PolyModulus<ValueType>(f);
+            frobenius = modulus.reduce(frobenius);
+        }
+    }
+    if (f.Degree() > 0) {  // what remains is irreducible
+        const int d = f.Degree();
+        res.emplace_back(std::move(f), d);
+    }
+    return res;
+}
+
+namespace polynomial_detail {
+
+template <typename Real>
+std::vector<std::complex<Real>> newton_polygon_start(const std::vector<std::complex<Real>>& coeffs) {
+    const size_t n = coeffs.size() - 1;
+    std::vector<size_t> hull;
+    std::vector<Real> logs(n + 1);
+    for (size_t i = 0; i <= n; ++i) {
+        if (coeffs[i] == std::complex<Real>(0)) {
+            continue;
+        }
+        logs[i] = std::log(std::abs(coeffs[i]));
+        // pop while the last hull point is not above the segment to the new one
+        while (hull.size() >= 2) {
+            const size_t a = hull[hull.size() - 2], b = hull.back();
+            if ((logs[b] - logs[a]) * (i - a) > (logs[i] - logs[a]) * (b - a)) {
+                break;
+            }
+            hull.pop_back();
+        }
+        hull.push_back(i);
+    }
+
+    // the angles are shifted on every circle so that the starting points are not symmetric
+    const Real PI = std::acos(Real(-1)), SHIFT = 0.7;
+    std::vector<std::complex<Real>> res;
+    for (size_t edge = 0; edge + 1 < hull.size(); ++edge) {
+        const size_t k = hull[edge], l = hull[edge + 1];
+        const Real radius = std::exp((logs[k] - logs[l]) / (l - k));
+        for (size_t j = 0; j < l - k; ++j) {
+            res.push_back(std::polar(radius, 2 * PI * j / (l - k) + 2 * PI * k / n + SHIFT));
+        }
+    }
+    return res;
+}
+
+template <typename Real>
+bool log_derivative(const std::vector<std::complex<Real>>& coeffs, const std::vector<Real>& bounds,
+                    const std::vector<Real>& rev_bounds, std::complex<Real> z, std::complex<Real>& res) {
+    const size_t n = coeffs.size() - 1;
+    const Real EPS = std::numeric_limits<Real>::epsilon();
+    std::complex<Real> value(0), deriv(0);
+    Real bound = 0;
+    if (std::abs(z) <= 1) {
+        const Real r = std::abs(z);
+        for (size_t i = n + 1; i-- > 0; ) {
+            deriv = deriv * z + value;
+            value = value * z + coeffs[i];
+            bound = bound * r + bounds[i];
+        }
+        if (std::abs(value) <= EPS * bound) {
+            return false;
+        }
+        res = deriv / value;
+        return true;
+    }
+
+    // p(z) = z^n * q(w) with q reversed and w = 1 / z: p' / p = w * (n - w * q'(w) / q(w))
+    const std::complex<Real> w = Real(1) / z;
+    const Real r = std::abs(w);
+    for (size_t i = 0; i <= n; ++i) {
+        deriv = deriv * w + value;
+        value = value * w + coeffs[i];
+        bound = bound * r + rev_bounds[n - i];
+    }
+    if (std::abs(value) <= EPS * bound) {
+        return false;
+    }
+    res = w * (Real(n) - w * deriv / value);
+    return true;
+}
+
+}  // namespace polynomial_detail
+
+template <typename ValueType>
+std::vector<std::complex<typename fft::real_type<ValueType>::type>> find_complex_roots(
+        const Polynomial<ValueType>& f, int max_iterations) {
+    static_assert(std::is_floating_point<ValueType>::value || polynomial_detail::is_complex<ValueType>::value,
+                  "find_complex_roots works over floating and complex coefficients");
+    using Real = typename fft::real_type<ValueType>::type;
+    using Complex = std::complex<Real>;
+
+    // the zero roots are exact, the rest are the roots of f / x^low
+    std::vector<Complex> roots, coeffs;
+    for (int deg = 0; deg <= f.Degree(); ++deg) {
+        if (coeffs.empty() && f[deg] == ValueType(0)) {
+            roots.emplace_back(0);
         } else {
-            b = b % a;
+            coeffs.emplace_back(f[deg]);
+        }
+    }
+    const size_t n = (coeffs.empty() ? 0 : coeffs.size() - 1);
+    if (n == 0) {
+        return roots;
+    }
+    if (n == 1) {
+        roots.push_back(-coeffs[0] / coeffs[1]);
+        return roots;
+    }
+
+    // rounding error bounds of Horner's rule at z and of the reversed one at 1 / z
+    std::vector<Real> bounds(n + 1), rev_bounds(n + 1);
+    for (size_t i = 0; i <= n; ++i) {
+        bounds[i] = std::abs(coeffs[i]) * (4 * i + 1);
+        rev_bounds[n - i] = std::abs(coeffs[i]) * (4 * (n - i) + 1);
+    }
+
+    // the approximations are kept as separate real and imaginary arrays,
+    // so that the O(n) sum over the other roots is a plain vectorizable loop;
+    // every sweep computes all the corrections from the same approximations (Jacobi style),
+    // which makes the loop over roots parallel as well
+    const std::vector<Complex> start = polynomial_detail::newton_polygon_start(coeffs);
+    std::vector<Real> re(n), im(n), new_re(n), new_im(n);
+    for (size_t i = 0; i < n; ++i) {
+        re[i] = start[i].real();
+        im[i] = start[i].imag();
+    }
+    std::vector<char> done(n, false);
+    for (int iteration = 0; iteration < max_iterations; ++iteration) {
+        long long active = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16) reduction(+ : active)
+#endif
+        for (long long idx = 0; idx < static_cast<long long>(n); ++idx) {
+            const size_t i = idx;
+            new_re[i] = re[i];
+            new_im[i] = im[i];
+            Complex ratio;
+            if (done[i] || !polynomial_detail::log_derivative(coeffs, bounds, rev_bounds,
+                                                               Complex(re[i], im[i]), ratio)) {
+                done[i] = true;
+                continue;
+            }
+            ++active;
+
+            Real sum_re = 0, sum_im = 0;
+            for (size_t j = 0; j < n; ++j) {
+                const Real dr = re[i] - re[j], di = im[i] - im[j];
+                const Real norm = dr * dr + di * di;
+                // j == i gives 0 / 0, the select keeps the loop branch-free
+                const Real scale = (j == i ? Real(0) : Real(1) / norm);
+                sum_re += dr * scale;
+                sum_im -= di * scale;
+            }
+            const Complex delta = Real(1) / (ratio - Complex(sum_re, sum_im));
+            new_re[i] -= delta.real();
+            new_im[i] -= delta.imag();
         }
+        re.swap(new_re);
+        im.swap(new_im);
+        if (active == 0) {
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        roots.emplace_back(re[i], im[i]);
     }
-    Polynomial<ValueType> res = a + b;
-    return res / Polynomial(res[res.Degree()]);
+    return roots;
 }
@@ -0,0 +1,331 @@
+#pragma once
+
+//
+// Created on 19/10/2026
+//
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "polynomial.h"
+
+// polynomial with N coefficients (formal degree N - 1) stored inline: no allocation, and every
+// evaluation is unrolled at compile time into straight-line multiply-adds, fused when FMA is available;
+// meant for fixed approximations evaluated in hot loops
+template <typename ValueType, size_t N>
+class StaticPolynomial {
+    static_assert(N > 0, "StaticPolynomial needs at least one coefficient");
+
+private:
+    std::array<ValueType, N> coeffs;
+
+    template <size_t DEG>
+    constexpr ValueType horner_from(const ValueType& arg) const;
+
+public:
+    constexpr StaticPolynomial();  // zero
+    constexpr explicit StaticPolynomial(const std::array<ValueType, N>&);
+    // coefficients from the constant term up
+    template <typename... Rest, typename = std::enable_if_t<sizeof...(Rest) + 1 == N>>
+    constexpr StaticPolynomial(const ValueType& first, const Rest&... rest);
+    // throws std::domain_error if poly has degree N or more
+    explicit StaticPolynomial(const Polynomial<ValueType>& poly);
+
+    explicit operator Polynomial<ValueType>() const;
+
+    static constexpr size_t size();
+
+    constexpr const ValueType& operator[](size_t index) const;
+    constexpr ValueType& operator[](size_t index);
+
+    constexpr const ValueType* begin() const;
+    constexpr const ValueType* end() const;
+
+    // Horner's rule as a chain of N - 1 dependent multiply-adds, each one fused (a single rounding)
+    // when FMA is available, so the last bits may differ from Polynomial::operator();
+    // fine when many independent points are evaluated
+    constexpr ValueType operator()(const ValueType& arg) const;
+
+    // Estrin's scheme: pairs c[2i] + c[2i + 1] x, then pairs of those with x^2, x^4, ...;
+    // about log2 N dependent steps instead of N - 1, for latency-bound single evaluations
+    constexpr ValueType estrin(const ValueType& arg) const;
+
+    // out[i] = value at points[i] for i in [0, count), Horner's rule on every point
+    void evaluate(const ValueType* points, size_t count, ValueType* out) const;
+};
+
+template <typename ValueType, typename... Rest>
+StaticPolynomial(ValueType, Rest...) -> StaticPolynomial<ValueType, sizeof...(Rest) + 1>;
+
+template <typename ValueType, size_t N, size_t M>
+constexpr StaticPolynomial<ValueType, (N > M ? N : M)> operator+(const StaticPolynomial<ValueType, N>& lhs,
+                                                                 const StaticPolynomial<ValueType, M>& rhs);
+
+template <typename ValueType, size_t N, size_t M>
+constexpr StaticPolynomial<ValueType, (N > M ? N : M)> operator-(const StaticPolynomial<ValueType, N>& lhs,
+                                                                 const StaticPolynomial<ValueType, M>& rhs);
+
+template <typename ValueType, size_t N>
+constexpr StaticPolynomial<ValueType, N> operator-(const StaticPolynomial<ValueType, N>& poly);
+
+template <typename ValueType, size_t N, size_t M>
+constexpr StaticPolynomial<ValueType, N + M - 1> operator*(const StaticPolynomial<ValueType, N>& lhs,
+                                                           const StaticPolynomial<ValueType, M>& rhs);
+
+template <typename ValueType, size_t N>
+constexpr StaticPolynomial<ValueType, N> operator*(const StaticPolynomial<ValueType, N>& lhs,
+                                                   const ValueType& rhs);
+
+template <typename ValueType, size_t N>
+constexpr StaticPolynomial<ValueType, N> operator*(const ValueType& lhs,
+                                                   const StaticPolynomial<ValueType, N>& rhs);
+
+template <typename ValueType, size_t N>
+constexpr bool operator==(const StaticPolynomial<ValueType, N>& lhs, const StaticPolynomial<ValueType, N>& rhs);
+
+template <typename ValueType, size_t N>
+constexpr bool operator!=(const StaticPolynomial<ValueType, N>& lhs, const StaticPolynomial<ValueType, N>& rhs);
+
+// the derivative keeps one coefficient for N = 1
+template <typename ValueType, size_t N>
+constexpr StaticPolynomial<ValueType, (N > 1 ? N - 1 : 1)> derivative(const StaticPolynomial<ValueType, N>& poly);
+
+template <typename ValueType, size_t N>
+std::ostream& operator<<(std::ostream& out, const StaticPolynomial<ValueType, N>& poly);
+
+namespace static_polynomial_detail {
+
+// a * b + c, one fused instruction for floating types when the target has FMA
+// and the call is not constant-evaluated (std::fma is not constexpr)
+template <typename ValueType>
+constexpr ValueType multiply_add(const ValueType& a, const ValueType& b, const ValueType& c);
+
+// one Estrin level: level[2i] + level[2i + 1] * power, the odd last element carried over
+template <typename ValueType, size_t N, size_t... INDICES>
+constexpr std::array<ValueType, (N + 1) / 2> estrin_level(const std::array<ValueType, N>& level,
+                                                          const ValueType& power,
+                                                          std::index_sequence<INDICES...>);
+
+template <typename ValueType, size_t N>
+constexpr ValueType estrin_reduce(const std::array<ValueType, N>& level, const ValueType& power);
+
+}  // namespace static_polynomial_detail
+
+//
+// implementation:
+//
+
+namespace static_polynomial_detail {
+
+template <typename ValueType>
+constexpr ValueType multiply_add(const ValueType& a, const ValueType& b, const ValueType& c) {
+#ifdef __FMA__
+    if constexpr (std::is_floating_point<ValueType>::value) {
+        if (!__builtin_is_constant_evaluated()) {
+            return std::fma(a, b, c);
+        }
+    }
+#endif
+    return a * b + c;
+}
+
+template <typename ValueType, size_t N, size_t... INDICES>
+constexpr std::array<ValueType, (N + 1) / 2> estrin_level(const std::array<ValueType, N>& level,
+                                                          const ValueType& power,
+                                                          std::index_sequence<INDICES...>) {
+    return {{(2 * INDICES + 1 < N ? multiply_add(level[2 * INDICES + 1], power, level[2 * INDICES])
+                                  : level[2 * INDICES])...}};
+}
+
+template <typename ValueType, size_t N>
+constexpr ValueType estrin_reduce(const std::array<ValueType, N>& level, const ValueType& power) {
+    if constexpr (N == 1) {
+        return level[0];
+    } else {
+        return estrin_reduce(estrin_level(level, power, std::make_index_sequence<(N + 1) / 2>()),
+                             power * power);
+    }
+}
+
+}  // namespace static_polynomial_detail
+
+template <typename ValueType, size_t N>
+constexpr StaticPolynomial<ValueType, N>::StaticPolynomial(): coeffs() {
+    for (size_t deg = 0; deg < N; ++deg) {
+        coeffs[deg] = ValueType(0);
+    }
+}
+
+template <typename ValueType, size_t N>
+constexpr StaticPolynomial<ValueType, N>::StaticPolynomial(const std::array<ValueType, N>& values)
+        : coeffs(values) {}
+
+template <typename ValueType, size_t N>
+template <typename... Rest, typename>
+constexpr StaticPolynomial<ValueType, N>::StaticPolynomial(const ValueType& first, const Rest&... rest)
+        : coeffs{{first, ValueType(rest)...}} {}
+
+template <typename ValueType, size_t N>
+StaticPolynomial<ValueType, N>::StaticPolynomial(const Polynomial<ValueType>& poly): StaticPolynomial() {
+    if (poly.Degree() >= static_cast<int>(N)) {
+        throw std::domain_error("StaticPolynomial: the degree does not fit");
+    }
+    for (int deg = 0; deg <= poly.Degree(); ++deg) {
+        coeffs[deg] = poly[deg];
+    }
+}
+
+template <typename ValueType, size_t N>
+StaticPolynomial<ValueType, N>::operator Polynomial<ValueType>() const {
+    return Polynomial<ValueType>(coeffs.begin(), coeffs.end());
+}
+
+template <typename ValueType, size_t N>
+constexpr size_t StaticPolynomial<ValueType, N>::size() {
+    return N;
+}
+
+template <typename ValueType, size_t N>
+constexpr const ValueType& StaticPolynomial<ValueType, N>::operator[](size_t index) const {
+    return coeffs[index];
+}
+
+template <typename ValueType, size_t N>
+constexpr ValueType& StaticPolynomial<ValueType, N>::operator[](size_t index) {
+    return coeffs[index];
+}
+
+template <typename ValueType, size_t N>
+constexpr const ValueType* StaticPolynomial<ValueType, N>::begin() const {
+    return coeffs.data();
+}
+
+template <typename ValueType, size_t N>
+constexpr const ValueType* StaticPolynomial<ValueType, N>::end() const {
+    return coeffs.data() + N;
+}
+
+template <typename ValueType, size_t N>
+template <size_t DEG>
+constexpr ValueType StaticPolynomial<ValueType, N>::horner_from(const ValueType& arg) const {
+    if constexpr (DEG + 1 == N) {
+        return coeffs[DEG];
+    } else {
+        return static_polynomial_detail::multiply_add(horner_from<DEG + 1>(arg), arg, coeffs[DEG]);
+    }
+}
+
+template <typename ValueType, size_t N>
+constexpr ValueType StaticPolynomial<ValueType, N>::operator()(const ValueType& arg) const {
+    return horner_from<0>(arg);
+}
+
+template <typename ValueType, size_t N>
+constexpr ValueType StaticPolynomial<ValueType, N>::estrin(const ValueType& arg) const {
+    return static_polynomial_detail::estrin_reduce(coeffs, arg);
+}
+
+template <typename ValueType, size_t N>
+void StaticPolynomial<ValueType, N>::evaluate(const ValueType* points, size_t count, ValueType* out) const {
+    // the body is straight-line code, so the loop vectorizes across the points
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = (*this)(points[i]);
+    }
+}
+
+template <typename ValueType, size_t N, size_t M>
+constexpr StaticPolynomial<ValueType, (N > M ? N : M)> operator+(const StaticPolynomial<ValueType, N>& lhs,
+                                                                 const StaticPolynomial<ValueType, M>& rhs) {
+    StaticPolynomial<ValueType, (N > M ? N : M)> res;
+    for (size_t deg = 0; deg < N; ++deg) {
+        res[deg] += lhs[deg];
+    }
+    for (size_t deg = 0; deg < M; ++deg) {
+        res[deg] += rhs[deg];
+    }
+    return res;
+}
+
+template <typename ValueType, size_t N, size_t M>
+constexpr StaticPolynomial<ValueType, (N > M ? N : M)> operator-(const StaticPolynomial<ValueType, N>& lhs,
+                                                                 const StaticPolynomial<ValueType, M>& rhs) {
+    StaticPolynomial<ValueType, (N > M ? N : M)> res;
+    for (size_t deg = 0; deg < N; ++deg) {
+        res[deg] += lhs[deg];
+    }
+    for (size_t deg = 0; deg < M; ++deg) {
+        res[deg] -= rhs[deg];
+    }
+    return res;
+}
+
+template <typename ValueType, size_t N>
+constexpr StaticPolynomial<ValueType, N> operator-(const StaticPolynomial<ValueType, N>& poly) {
+    StaticPolynomial<ValueType, N> res;
+    for (size_t deg = 0; deg < N; ++deg) {
+        res[deg] = -poly[deg];
+    }
+    return res;
+}
+
+template <typename ValueType, size_t N, size_t M>
+constexpr StaticPolynomial<ValueType, N + M - 1> operator*(const StaticPolynomial<ValueType, N>& lhs,
+                                                           const StaticPolynomial<ValueType, M>& rhs) {
+    StaticPolynomial<ValueType, N + M - 1> res;
+    for (size_t ldeg = 0; ldeg < N; ++ldeg) {
+        for (size_t rdeg = 0; rdeg < M; ++rdeg) {
+            res[ldeg + rdeg] += lhs[ldeg] * rhs[rdeg];
+        }
+    }
+    return res;
+}
+
+template <typename ValueType, size_t N>
+constexpr StaticPolynomial<ValueType, N> operator*(const StaticPolynomial<ValueType, N>& lhs,
+                                                   const ValueType& rhs) {
+    StaticPolynomial<ValueType, N> res;
+    for (size_t deg = 0; deg < N; ++deg) {
+        res[deg] = lhs[deg] * rhs;
+    }
+    return res;
+}
+
+template <typename ValueType, size_t N>
+constexpr StaticPolynomial<ValueType, N> operator*(const ValueType& lhs,
+                                                   const StaticPolynomial<ValueType, N>& rhs) {
+    return rhs * lhs;
+}
+
+template <typename ValueType, size_t N>
+constexpr bool operator==(const StaticPolynomial<ValueType, N>& lhs, const StaticPolynomial<ValueType, N>& rhs) {
+    for (size_t deg = 0; deg < N; ++deg) {
+        if (!(lhs[deg] == rhs[deg])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename ValueType, size_t N>
+constexpr bool operator!=(const StaticPolynomial<ValueType, N>& lhs, const StaticPolynomial<ValueType, N>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename ValueType, size_t N>
+constexpr StaticPolynomial<ValueType, (N > 1 ? N - 1 : 1)> derivative(const StaticPolynomial<ValueType, N>& poly) {
+    StaticPolynomial<ValueType, (N > 1 ? N - 1 : 1)> res;
+    for (size_t deg = 1; deg < N; ++deg) {
+        res[deg - 1] = poly[deg] * ValueType(deg);
+    }
+    return res;
+}
+
+template <typename ValueType, size_t N>
+std::ostream& operator<<(std::ostream& out, const StaticPolynomial<ValueType, N>& poly) {
+    return out << static_cast<Polynomial<ValueType>>(poly);
+}
@@ -0,0 +1,590 @@
+#pragma once
+
+//
+// Created on 19/10/2026
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "sparse_terms.h"
+
+namespace adaptive_detail {
+
+// polynomials with at most this many coefficients up to the degree are always dense
+const size_t SMALL_SIZE = 16;
+
+// a dense polynomial becomes sparse when fewer than 1 / SPARSE_FILL of its coeffs are nonzero,
+// a sparse one becomes dense when more than 1 / DENSE_FILL are;
+// the gap between the two keeps the storage from flipping back and forth
+const size_t SPARSE_FILL = 8;
+const size_t DENSE_FILL = 4;
+
+// the storage an operation should write its result to: dense for
+// the given number of (at most) nonzero terms among size coefficients
+inline bool prefers_dense(size_t terms, size_t size) {
+    return size <= SMALL_SIZE || terms * SPARSE_FILL >= size;
+}
+
+}  // namespace adaptive_detail
+
+// Polynomial that keeps either all the coeffs up to the degree (like poly_dense.h)
+// or only the nonzero {degree, coeff} terms sorted by degree (like poly_sparse_flat.h),
+// switching by the share of nonzero coeffs after every modification.
+// The arithmetic picks the kernel by the forms of both operands,
+// e.g. sparse * dense adds one shifted copy of the dense factor per sparse term.
+// Iteration yields the nonzero {degree, coeff} terms in either form.
+template <typename ValueType>
+class Polynomial {
+private:
+    // dense_form: coeffs up to the degree in dense, otherwise nonzero terms in sparse;
+    // the other vector is empty
+    bool dense_form;
+    std::vector<ValueType> dense;
+    std::vector<std::pair<size_t, ValueType>> sparse;
+    size_t term_count;
+    ValueType ZERO;
+
+    void delete_leading_zeros();
+    // sorts the sparse terms, sums up equal degrees and drops zeros
+    void normalize();
+    void make_dense();
+    void make_sparse();
+    // recounts the terms and switches the storage if the fill ratio asks for it
+    void adapt();
+
+    // *this += rhs or *this -= rhs
+    void add(const Polynomial<ValueType>& rhs, bool subtract);
+
+public:
+    class TermIterator;
+
+    explicit Polynomial(const std::vector<ValueType>&);
+    explicit Polynomial(const ValueType& = ValueType());
+    // {degree, coeff} terms in any order, the coeffs of equal degrees are summed up
+    explicit Polynomial(std::vector<std::pair<size_t, ValueType>> terms);
+    template <typename Iter>
+    Polynomial(Iter first, Iter last);
+
+    int Degree() const;
+    // number of nonzero terms
+    size_t Terms() const;
+    bool IsDense() const;
+
+    const ValueType& operator[](size_t index) const;
+
+    ValueType operator()(const ValueType&) const;
+
+    TermIterator begin() const;
+    TermIterator end() const;
+
+    Polynomial<ValueType>& operator+=(const Polynomial<ValueType>&);
+    Polynomial<ValueType>& operator+=(const ValueType&);
+
+    Polynomial<ValueType>& operator-=(const Polynomial<ValueType>&);
+    Polynomial<ValueType>& operator-=(const ValueType&);
+
+    Polynomial<ValueType>& operator*=(const Polynomial<ValueType>&);
+    Polynomial<ValueType>& operator*=(const ValueType&);
+};
+
+// yields the nonzero terms as {degree, coeff} pairs in the order of degrees
+template <typename ValueType>
+class Polynomial<ValueType>::TermIterator {
+private:
+    const Polynomial<ValueType>* poly;
+    size_t pos;  // index in dense or sparse
+
+    void skip_zeros() {
+        if (poly->dense_form) {
+            while (pos < poly->dense.size() && poly->dense[pos] == poly->ZERO) {
+                ++pos;
+            }
+        }
+    }
+
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::pair<size_t, ValueType>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = value_type;
+
+    TermIterator(const Polynomial<ValueType>* poly, size_t pos): poly(poly), pos(pos) {
+        skip_zeros();
+    }
+
+    value_type operator*() const {
+        return (poly->dense_form ? value_type(pos, poly->dense[pos]) : poly->sparse[pos]);
+    }
+
+    TermIterator& operator++() {
+        ++pos;
+        skip_zeros();
+        return *this;
+    }
+
+    TermIterator operator++(int) {
+        TermIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    bool operator==(const TermIterator& other) const {
+        return pos == other.pos;
+    }
+
+    bool operator!=(const TermIterator& other) const {
+        return pos != other.pos;
+    }
+};
+
+template<typename ValueType>
+void Polynomial<ValueType>::delete_leading_zeros() {
+    while (!dense.empty() && dense.back() == ZERO) {
+        dense.pop_back();
+    }
+}
+
+template<typename ValueType>
+void Polynomial<ValueType>::normalize() {
+    auto by_degree = [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; };
+    if (!std::is_sorted(sparse.begin(), sparse.end(), by_degree)) {
+        std::stable_sort(sparse.begin(), sparse.end(), by_degree);
+    }
+
+    size_t size = 0;
+    for (size_t i = 0; i < sparse.size(); ) {
+        std::pair<size_t, ValueType> term = sparse[i];
+        for (++i; i < sparse.size() && sparse[i].first == term.first; ++i) {
+            term.second += sparse[i].second;
+        }
+        if (term.second != ZERO) {
+            sparse[size++] = term;
+        }
+    }
+    sparse.resize(size);
+}
+
+template<typename ValueType>
+void Polynomial<ValueType>::make_dense() {
+    if (dense_form) {
+        return;
+    }
+    dense.assign(sparse.empty() ? 0 : sparse.back().first + 1, ZERO);
+    for (const auto& [deg, coeff] : sparse) {
+        dense[deg] = coeff;
+    }
+    sparse.clear();
+    sparse.shrink_to_fit();
+    dense_form = true;
+}
+
+template<typename ValueType>
+void Polynomial<ValueType>::make_sparse() {
+    if (!dense_form) {
+        return;
+    }
+    sparse.clear();
+    for (size_t deg = 0; deg < dense.size(); ++deg) {
+        if (dense[deg] != ZERO) {
+            sparse.emplace_back(deg, dense[deg]);
+        }
+    }
+    dense.clear();
+    dense.shrink_to_fit();
+    dense_form = false;
+}
+
+template<typename ValueType>
+void Polynomial<ValueType>::adapt() {
+    const size_t size = Degree() + 1;
+    if (dense_form) {
+        term_count = std::count_if(dense.begin(), dense.end(),
+                                   [this](const ValueType& coeff) { return coeff != ZERO; });
+        if (size > adaptive_detail::SMALL_SIZE && term_count * adaptive_detail::SPARSE_FILL < size) {
+            make_sparse();
+        }
+    } else {
+        term_count = sparse.size();
+        if (size <= adaptive_detail::SMALL_SIZE || term_count * adaptive_detail::DENSE_FILL > size) {
+            make_dense();
+        }
+    }
+}
+
+template<typename ValueType>
+Polynomial<ValueType>::Polynomial(const std::vector<ValueType>& coeffs_vec):
+        dense_form(true), dense(coeffs_vec), ZERO(ValueType(0)) {
+    delete_leading_zeros();
+    adapt();
+}
+
+template<typename ValueType>
+Polynomial<ValueType>::Polynomial(const ValueType& coeff):
+        dense_form(true), dense{coeff}, ZERO(ValueType(0)) {
+    delete_leading_zeros();
+    adapt();
+}
+
+template<typename ValueType>
+Polynomial<ValueType>::Polynomial(std::vector<std::pair<size_t, ValueType>> terms):
+        dense_form(false), sparse(std::move(terms)), ZERO(ValueType(0)) {
+    normalize();
+    adapt();
+}
+
+template<typename ValueType>
+template<typename Iter>
+Polynomial<ValueType>::Polynomial(Iter first, Iter last):
+        Polynomial<ValueType>(std::vector<ValueType>(first, last)) {}
+
+template<typename ValueType>
+int Polynomial<ValueType>::Degree() const {
+    if (dense_form) {
+        return static_cast<int>(dense.size()) - 1;
+    }
+    return (sparse.empty() ? -1 : static_cast<int>(sparse.back().first));
+}
+
+template<typename ValueType>
+size_t Polynomial<ValueType>::Terms() const {
+    return term_count;
+}
+
+template<typename ValueType>
+bool Polynomial<ValueType>::IsDense() const {
+    return dense_form;
+}
+
+template<typename ValueType>
+const ValueType& Polynomial<ValueType>::operator[](size_t index) const {
+    if (dense_form) {
+        return (index < dense.size() ? dense[index] : ZERO);
+    }
+    auto it = std::lower_bound(sparse.begin(), sparse.end(), index,
+                               [](const auto& term, size_t deg) { return term.first < deg; });
+    return (it == sparse.end() || it->first != index ? ZERO : it->second);
+}
+
+template<typename ValueType>
+ValueType Polynomial<ValueType>::operator()(const ValueType& arg) const {
+    ValueType res(0);
+    if (dense_form) {
+        for (size_t deg = dense.size(); deg-- > 0; ) {
+            res = res * arg + dense[deg];
+        }
+        return res;
+    }
+
+    return sparse_terms::evaluate(sparse.crbegin(), sparse.crend(), arg);
+}
+
+template<typename ValueType>
+typename Polynomial<ValueType>::TermIterator Polynomial<ValueType>::begin() const {
+    return TermIterator(this, 0);
+}
+
+template<typename ValueType>
+typename Polynomial<ValueType>::TermIterator Polynomial<ValueType>::end() const {
+    return TermIterator(this, dense_form ? dense.size() : sparse.size());
+}
+
+template<typename ValueType>
+void Polynomial<ValueType>::add(const Polynomial<ValueType>& rhs, bool subtract) {
+    const size_t size = std::max(Degree(), rhs.Degree()) + 1;
+    if (adaptive_detail::prefers_dense(Terms() + rhs.Terms(), size)) {
+        // dense += dense or dense += sparse: coefficient-wise
+        make_dense();
+        if (dense.size() < size) {
+            dense.resize(size, ZERO);
+        }
+        if (rhs.dense_form) {
+            for (size_t deg = 0; deg < rhs.dense.size(); ++deg) {
+                dense[deg] = (subtract ? dense[deg] - rhs.dense[deg] : dense[deg] + rhs.dense[deg]);
+            }
+        } else {
+            for (const auto& [deg, coeff] : rhs.sparse) {
+                dense[deg] = (subtract ? dense[deg] - coeff : dense[deg] + coeff);
+            }
+        }
+        delete_leading_zeros();
+    } else {
+        // sparse += anything: merge of the two sorted term sequences
+        make_sparse();
+        std::vector<std::pair<size_t, ValueType>> res;
+        res.reserve(Terms() + rhs.Terms());
+        sparse_terms::merge(sparse.cbegin(), sparse.cend(), rhs.begin(), rhs.end(), subtract,
+                            [&res](size_t deg, const ValueType& coeff) { res.emplace_back(deg, coeff); });
+        sparse = std::move(res);
+    }
+    adapt();
+}
+
+template<typename ValueType>
+Polynomial<ValueType> &Polynomial<ValueType>::operator+=(const Polynomial<ValueType>& add) {
+    this->add(add, false);
+    return *this;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> &Polynomial<ValueType>::operator+=(const ValueType& add) {
+    return (*this += Polynomial(add));
+}
+
+template<typename ValueType>
+Polynomial<ValueType> &Polynomial<ValueType>::operator-=(const Polynomial<ValueType>& add) {
+    this->add(add, true);
+    return *this;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> &Polynomial<ValueType>::operator-=(const ValueType& add) {
+    return (*this -= Polynomial(add));
+}
+
+template<typename ValueType>
+Polynomial<ValueType>& Polynomial<ValueType>::operator*=(const Polynomial<ValueType>& rhs) {
+    if (Degree() == -1 || rhs.Degree() == -1) {
+        return (*this = Polynomial<ValueType>(ZERO));
+    }
+
+    // the outer loop runs over the operand with fewer terms
+    // (*this is only read until the result is assigned)
+    const bool outer_is_this = Terms() <= rhs.Terms();
+    const Polynomial<ValueType>& outer = (outer_is_this ? *this : rhs);
+    const Polynomial<ValueType>& inner = (outer_is_this ? rhs : *this);
+
+    const size_t size = Degree() + rhs.Degree() + 1;
+    if (adaptive_detail::prefers_dense(std::min(Terms() * rhs.Terms(), size), size)) {
+        // one shifted copy of inner per term of outer: dense * dense is the schoolbook product,
+        // sparse * dense touches only the coefficients the sparse terms reach
+        std::vector<ValueType> res(size, ZERO);
+        for (const auto& [odeg, ocoeff] : outer) {
+            if (inner.dense_form) {
+                ValueType* row = res.data() + odeg;
+                for (size_t ideg = 0; ideg < inner.dense.size(); ++ideg) {
+                    row[ideg] += ocoeff * inner.dense[ideg];
+                }
+            } else {
+                for (const auto& [ideg, icoeff] : inner.sparse) {
+                    res[odeg + ideg] += ocoeff * icoeff;
+                }
+            }
+        }
+        return (*this = Polynomial<ValueType>(res));
+    }
+
+    // sparse result: the heap multiply, one heap entry per term of outer
+    std::vector<std::pair<size_t, ValueType>> res;
+    sparse_terms::heap_multiply(outer.begin(), outer.end(), inner.begin(), inner.end(),
+                                [&res](size_t deg, const ValueType& coeff) { res.emplace_back(deg, coeff); });
+    return (*this = Polynomial<ValueType>(std::move(res)));
+}
+
+template<typename ValueType>
+Polynomial<ValueType>& Polynomial<ValueType>::operator*=(const ValueType& rhs) {
+    for (auto& coeff : dense) {
+        coeff *= rhs;
+    }
+    for (auto& term : sparse) {
+        term.second *= rhs;
+    }
+    delete_leading_zeros();
+    normalize();
+    adapt();
+    return *this;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(const Polynomial<ValueType>& lhs,
+                                const Polynomial<ValueType>& rhs) {
+    Polynomial<ValueType> res = lhs;
+    res += rhs;
+    return res;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    return lhs + Polynomial(rhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    return rhs + lhs;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(const Polynomial<ValueType>& lhs,
+                                const Polynomial<ValueType>& rhs) {
+    Polynomial<ValueType> res = lhs;
+    res -= rhs;
+    return res;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    return lhs - Polynomial(rhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    return Polynomial(lhs) - rhs;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator*(const Polynomial<ValueType>& lhs,
+                                const Polynomial<ValueType>& rhs) {
+    Polynomial<ValueType> res = lhs;
+    res *= rhs;
+    return res;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator*(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    Polynomial<ValueType> res = lhs;
+    res *= rhs;
+    return res;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator*(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    return rhs * lhs;
+}
+
+template<typename ValueType>
+bool operator==(const Polynomial<ValueType>& lhs, const Polynomial<ValueType>& rhs) {
+    return lhs.Terms() == rhs.Terms() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template<typename ValueType>
+bool operator==(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    return (lhs.Degree() <= 0) && (lhs[0] == rhs);
+}
+
+template<typename ValueType>
+bool operator==(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    return (rhs == lhs);
+}
+
+template<typename ValueType>
+bool operator!=(const Polynomial<ValueType>& lhs, const Polynomial<ValueType>& rhs) {
+    return !(lhs == rhs);
+}
+
+template<typename ValueType>
+bool operator!=(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    return !(lhs == rhs);
+}
+
+template<typename ValueType>
+bool operator!=(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    return !(lhs == rhs);
+}
+
+template<typename ValueType>
+ValueType abs(const ValueType& num) {
+    if (num > ValueType(0)) {
+        return num;
+    } else {
+        return -num;
+    }
+}
+
+template<typename ValueType>
+std::ostream& operator<<(std::ostream& out, const Polynomial<ValueType>& poly) {
+    if (poly.Degree() == -1) {
+        out << ValueType(0);
+    } else {
+        const std::vector<std::pair<size_t, ValueType>> terms(poly.begin(), poly.end());
+        for (auto it = terms.rbegin(); it != terms.rend(); ++it) {
+            const auto& [deg, coeff] = *it;
+            ValueType abs_coeff = abs(coeff);
+
+            if (abs_coeff == coeff) {  // +
+                if (static_cast<int>(deg) != poly.Degree()) {
+                    out << '+';
+                }
+            } else {  // -
+                out << '-';
+            }
+
+            if (deg == 0 || abs_coeff != ValueType(1)) {
+                out << abs_coeff;
+                if (deg != 0) {
+                    out << '*';
+                }
+            }
+
+            if (deg != 0) {
+                out << 'x';
+                if (deg > 1) {
+                    out << '^' << deg;
+                }
+            }
+        }
+    }
+    return out;
+}
+
+// returns f(g(x))
+template <typename ValueType>
+Polynomial<ValueType> operator&(const Polynomial<ValueType>& f, const Polynomial<ValueType>& g) {
+    const std::vector<std::pair<size_t, ValueType>> terms(f.begin(), f.end());
+    return sparse_terms::evaluate(terms.crbegin(), terms.crend(), g);
+}
+
+template <typename ValueType>
+Polynomial<ValueType> x_pow(size_t pow) {
+    return Polynomial<ValueType>(std::vector<std::pair<size_t, ValueType>>{{pow, ValueType(1)}});
+}
+
+template <typename ValueType>
+Polynomial<ValueType> operator/(Polynomial<ValueType> dividend,
+                                const Polynomial<ValueType>& divisor) {
+    Polynomial<ValueType> res(ValueType(0));
+    if (dividend.Degree() < divisor.Degree()) {
+        return res;
+    }
+
+    for (int cur_pow = dividend.Degree() - divisor.Degree(); cur_pow >= 0; ) {
+        Polynomial<ValueType> cur_mult =
+                (dividend[dividend.Degree()] / divisor[divisor.Degree()])
+                * x_pow<ValueType>(cur_pow);
+
+        if (cur_mult == Polynomial<ValueType>(ValueType(0))) {
+            break;
+        }
+
+        dividend -= cur_mult * divisor;
+        res += cur_mult;
+
+        cur_pow = dividend.Degree() - divisor.Degree();
+    }
+
+    return res;
+}
+
+template <typename ValueType>
+Polynomial<ValueType> operator%(const Polynomial<ValueType>& dividend,
+                                const Polynomial<ValueType>& divisor) {
+    return dividend - (dividend / divisor) * divisor;
+}
+
+template <typename ValueType>
+Polynomial<ValueType> operator,(Polynomial<ValueType> a, Polynomial<ValueType> b) {
+    while (a.Degree() != -1 && b.Degree() != -1) {
+        if (a.Degree() > b.Degree() ||
+            (a.Degree() == b.Degree() && a[a.Degree()] > b[b.Degree()])) {
+            a = a % b;
+        } else {
+            b = b % a;
+        }
+    }
+    Polynomial<ValueType> res = a + b;
+    return res / Polynomial(res[res.Degree()]);
+}
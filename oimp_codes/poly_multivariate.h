@@ -0,0 +1,487 @@
+#pragma once
+
+//
+// Created on 19/10/2026
+//
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "sparse_terms.h"
+
+enum class MonomialOrder {
+    Lex,        // x_0 > x_1 > ... > x_(NVARS - 1), compared exponent by exponent
+    GradedLex,  // total degree first, then Lex
+};
+
+// Monomial x_0^e_0 * ... * x_(NVARS - 1)^e_(NVARS - 1) packed into 64-bit words, 16 bits per field.
+// The fields go from the most significant bits on, so comparing the words as integers
+// compares the monomials in the chosen order; GradedLex keeps the total degree in the first field.
+// Exponents (and total degrees for GradedLex) are limited by MAX_EXPONENT:
+// the top bit of every field is a guard that catches overflows of the packed multiplication
+// (an addition of the words), which throws std::overflow_error.
+template <size_t NVARS, MonomialOrder ORDER = MonomialOrder::GradedLex>
+class Monomial {
+private:
+    static constexpr size_t FIELD_BITS = 16;
+    static constexpr size_t FIELDS_PER_WORD = 64 / FIELD_BITS;
+    static constexpr size_t FIRST_VAR = (ORDER == MonomialOrder::GradedLex ? 1 : 0);
+    static constexpr size_t FIELDS = NVARS + FIRST_VAR;
+    static constexpr size_t WORDS = (FIELDS + FIELDS_PER_WORD - 1) / FIELDS_PER_WORD;
+    static constexpr uint64_t GUARDS = 0x8000800080008000ULL;
+
+    std::array<uint64_t, WORDS> words{};
+
+    static size_t shift(size_t field) {
+        return 64 - FIELD_BITS * (field % FIELDS_PER_WORD + 1);
+    }
+
+    unsigned field(size_t index) const {
+        return (words[index / FIELDS_PER_WORD] >> shift(index)) & ((1u << FIELD_BITS) - 1);
+    }
+
+public:
+    static constexpr unsigned MAX_EXPONENT = (1u << (FIELD_BITS - 1)) - 1;
+
+    // the monomial 1
+    Monomial() = default;
+    explicit Monomial(const std::array<unsigned, NVARS>& exponents);
+
+    unsigned Exponent(size_t var) const;
+    unsigned Degree() const;
+
+    // throws std::overflow_error if an exponent (or the total degree for GradedLex) exceeds MAX_EXPONENT
+    Monomial& operator*=(const Monomial& rhs);
+
+    bool operator==(const Monomial& rhs) const;
+    bool operator!=(const Monomial& rhs) const;
+    bool operator<(const Monomial& rhs) const;
+    bool operator>(const Monomial& rhs) const;
+};
+
+// Sparse polynomial in NVARS variables: the nonzero {monomial, coeff} terms
+// in one array sorted by the monomial order, the term map of poly_sparse.h without the tree nodes.
+// Multiplication merges the rows lhs_i * rhs through a heap of packed monomials.
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER = MonomialOrder::GradedLex>
+class MultivariatePolynomial {
+public:
+    using MonomialType = Monomial<NVARS, ORDER>;
+    using Term = std::pair<MonomialType, ValueType>;
+
+private:
+    // increasing monomials, no zero coeffs
+    std::vector<Term> terms;
+    ValueType ZERO;
+
+    // sorts the terms, sums up the coeffs of equal monomials and drops zeros
+    void normalize();
+
+public:
+    explicit MultivariatePolynomial(const ValueType& = ValueType());
+    // terms in any order, the coeffs of equal monomials are summed up
+    explicit MultivariatePolynomial(std::vector<Term> terms_vec);
+
+    // the polynomial x_var
+    static MultivariatePolynomial Variable(size_t var);
+
+    // total degree, -1 for the zero polynomial
+    int Degree() const;
+    // number of nonzero terms
+    size_t Terms() const;
+    // the greatest monomial in the order, the polynomial must be nonzero
+    const Term& Leading() const;
+
+    const ValueType& operator[](const MonomialType& monomial) const;
+
+    ValueType operator()(const std::array<ValueType, NVARS>& point) const;
+
+    typename std::vector<Term>::const_iterator begin() const;
+    typename std::vector<Term>::const_iterator end() const;
+
+    MultivariatePolynomial& operator+=(const MultivariatePolynomial&);
+    MultivariatePolynomial& operator+=(const ValueType&);
+
+    MultivariatePolynomial& operator-=(const MultivariatePolynomial&);
+    MultivariatePolynomial& operator-=(const ValueType&);
+
+    MultivariatePolynomial& operator*=(const MultivariatePolynomial&);
+    MultivariatePolynomial& operator*=(const ValueType&);
+};
+
+//
+// implementation:
+//
+
+template <size_t NVARS, MonomialOrder ORDER>
+Monomial<NVARS, ORDER>::Monomial(const std::array<unsigned, NVARS>& exponents) {
+    unsigned long long degree = 0;
+    for (size_t var = 0; var < NVARS; ++var) {
+        if (exponents[var] > MAX_EXPONENT) {
+            throw std::overflow_error("Monomial: exponent is too large");
+        }
+        degree += exponents[var];
+        words[(var + FIRST_VAR) / FIELDS_PER_WORD] |=
+                static_cast<uint64_t>(exponents[var]) << shift(var + FIRST_VAR);
+    }
+    if constexpr (ORDER == MonomialOrder::GradedLex) {
+        if (degree > MAX_EXPONENT) {
+            throw std::overflow_error("Monomial: total degree is too large");
+        }
+        words[0] |= degree << shift(0);
+    }
+}
+
+template <size_t NVARS, MonomialOrder ORDER>
+unsigned Monomial<NVARS, ORDER>::Exponent(size_t var) const {
+    return field(var + FIRST_VAR);
+}
+
+template <size_t NVARS, MonomialOrder ORDER>
+unsigned Monomial<NVARS, ORDER>::Degree() const {
+    if constexpr (ORDER == MonomialOrder::GradedLex) {
+        return field(0);
+    } else {
+        unsigned degree = 0;
+        for (size_t var = 0; var < NVARS; ++var) {
+            degree += Exponent(var);
+        }
+        return degree;
+    }
+}
+
+template <size_t NVARS, MonomialOrder ORDER>
+Monomial<NVARS, ORDER>& Monomial<NVARS, ORDER>::operator*=(const Monomial& rhs) {
+    // the fields are below the guards, so they add up without carries into each other
+    uint64_t overflow = 0;
+    for (size_t word = 0; word < WORDS; ++word) {
+        words[word] += rhs.words[word];
+        overflow |= words[word] & GUARDS;
+    }
+    if (overflow != 0) {
+        throw std::overflow_error("Monomial: exponent overflow");
+    }
+    return *this;
+}
+
+template <size_t NVARS, MonomialOrder ORDER>
+Monomial<NVARS, ORDER> operator*(Monomial<NVARS, ORDER> lhs, const Monomial<NVARS, ORDER>& rhs) {
+    lhs *= rhs;
+    return lhs;
+}
+
+template <size_t NVARS, MonomialOrder ORDER>
+bool Monomial<NVARS, ORDER>::operator==(const Monomial& rhs) const {
+    return words == rhs.words;
+}
+
+template <size_t NVARS, MonomialOrder ORDER>
+bool Monomial<NVARS, ORDER>::operator!=(const Monomial& rhs) const {
+    return words != rhs.words;
+}
+
+template <size_t NVARS, MonomialOrder ORDER>
+bool Monomial<NVARS, ORDER>::operator<(const Monomial& rhs) const {
+    return words < rhs.words;
+}
+
+template <size_t NVARS, MonomialOrder ORDER>
+bool Monomial<NVARS, ORDER>::operator>(const Monomial& rhs) const {
+    return words > rhs.words;
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+void MultivariatePolynomial<ValueType, NVARS, ORDER>::normalize() {
+    auto by_monomial = [](const Term& lhs, const Term& rhs) { return lhs.first < rhs.first; };
+    if (!std::is_sorted(terms.begin(), terms.end(), by_monomial)) {
+        std::stable_sort(terms.begin(), terms.end(), by_monomial);
+    }
+
+    size_t size = 0;
+    for (size_t i = 0; i < terms.size(); ) {
+        Term term = terms[i];
+        for (++i; i < terms.size() && terms[i].first == term.first; ++i) {
+            term.second += terms[i].second;
+        }
+        if (term.second != ZERO) {
+            terms[size++] = term;
+        }
+    }
+    terms.resize(size);
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER>::MultivariatePolynomial(const ValueType& coeff):
+        ZERO(ValueType(0)) {
+    if (coeff != ZERO) {
+        terms.emplace_back(MonomialType(), coeff);
+    }
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER>::MultivariatePolynomial(std::vector<Term> terms_vec):
+        terms(std::move(terms_vec)), ZERO(ValueType(0)) {
+    normalize();
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER>::Variable(size_t var) {
+    std::array<unsigned, NVARS> exponents{};
+    exponents[var] = 1;
+    return MultivariatePolynomial(std::vector<Term>{{MonomialType(exponents), ValueType(1)}});
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+int MultivariatePolynomial<ValueType, NVARS, ORDER>::Degree() const {
+    if constexpr (ORDER == MonomialOrder::GradedLex) {
+        return (terms.empty() ? -1 : static_cast<int>(terms.back().first.Degree()));
+    } else {
+        int degree = -1;
+        for (const auto& term : terms) {
+            degree = std::max(degree, static_cast<int>(term.first.Degree()));
+        }
+        return degree;
+    }
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+size_t MultivariatePolynomial<ValueType, NVARS, ORDER>::Terms() const {
+    return terms.size();
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+const typename MultivariatePolynomial<ValueType, NVARS, ORDER>::Term&
+MultivariatePolynomial<ValueType, NVARS, ORDER>::Leading() const {
+    return terms.back();
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+const ValueType& MultivariatePolynomial<ValueType, NVARS, ORDER>::operator[](
+        const MonomialType& monomial) const {
+    auto it = std::lower_bound(terms.begin(), terms.end(), monomial,
+                               [](const Term& term, const MonomialType& mon) { return term.first < mon; });
+    if (it == terms.end() || it->first != monomial) {
+        return ZERO;
+    } else {
+        return it->second;
+    }
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+ValueType MultivariatePolynomial<ValueType, NVARS, ORDER>::operator()(
+        const std::array<ValueType, NVARS>& point) const {
+    // powers of every variable up to its largest exponent, computed once
+    std::array<std::vector<ValueType>, NVARS> powers;
+    for (size_t var = 0; var < NVARS; ++var) {
+        powers[var].push_back(ValueType(1));
+    }
+    ValueType res(0);
+    for (const auto& [monomial, coeff] : terms) {
+        ValueType value = coeff;
+        for (size_t var = 0; var < NVARS; ++var) {
+            const unsigned exp = monomial.Exponent(var);
+            while (powers[var].size() <= exp) {
+                powers[var].push_back(powers[var].back() * point[var]);
+            }
+            value *= powers[var][exp];
+        }
+        res += value;
+    }
+    return res;
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+typename std::vector<typename MultivariatePolynomial<ValueType, NVARS, ORDER>::Term>::const_iterator
+MultivariatePolynomial<ValueType, NVARS, ORDER>::begin() const {
+    return terms.cbegin();
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+typename std::vector<typename MultivariatePolynomial<ValueType, NVARS, ORDER>::Term>::const_iterator
+MultivariatePolynomial<ValueType, NVARS, ORDER>::end() const {
+    return terms.cend();
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER>&
+MultivariatePolynomial<ValueType, NVARS, ORDER>::operator+=(const MultivariatePolynomial& add) {
+    return (*this = *this + add);
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER>&
+MultivariatePolynomial<ValueType, NVARS, ORDER>::operator+=(const ValueType& add) {
+    return (*this = *this + MultivariatePolynomial(add));
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER>&
+MultivariatePolynomial<ValueType, NVARS, ORDER>::operator-=(const MultivariatePolynomial& add) {
+    return (*this = *this - add);
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER>&
+MultivariatePolynomial<ValueType, NVARS, ORDER>::operator-=(const ValueType& add) {
+    return (*this = *this - MultivariatePolynomial(add));
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER>&
+MultivariatePolynomial<ValueType, NVARS, ORDER>::operator*=(const MultivariatePolynomial& rhs) {
+    return (*this = *this * rhs);
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER>&
+MultivariatePolynomial<ValueType, NVARS, ORDER>::operator*=(const ValueType& rhs) {
+    for (auto& term : terms) {
+        term.second *= rhs;
+    }
+    normalize();  // zero divisors
+    return *this;
+}
+
+namespace multivariate_detail {
+
+// lhs + rhs or lhs - rhs by merging the two sorted term arrays
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER> merge_terms(
+        const MultivariatePolynomial<ValueType, NVARS, ORDER>& lhs,
+        const MultivariatePolynomial<ValueType, NVARS, ORDER>& rhs, bool subtract) {
+    using Poly = MultivariatePolynomial<ValueType, NVARS, ORDER>;
+    std::vector<typename Poly::Term> res;
+    res.reserve(lhs.Terms() + rhs.Terms());
+    sparse_terms::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), subtract,
+                        [&res](const typename Poly::MonomialType& monomial, const ValueType& coeff) {
+                            res.emplace_back(monomial, coeff);
+                        });
+    return Poly(std::move(res));
+}
+
+// lhs * rhs by the heap method of sparse_terms.h keyed by the packed monomials,
+// lhs should have fewer terms
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER> heap_multiply(
+        const MultivariatePolynomial<ValueType, NVARS, ORDER>& lhs,
+        const MultivariatePolynomial<ValueType, NVARS, ORDER>& rhs) {
+    using Poly = MultivariatePolynomial<ValueType, NVARS, ORDER>;
+    std::vector<typename Poly::Term> res;
+    sparse_terms::heap_multiply(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                                [&res](const typename Poly::MonomialType& monomial, const ValueType& coeff) {
+                                    res.emplace_back(monomial, coeff);
+                                },
+                                std::multiplies<>());
+    return Poly(std::move(res));
+}
+
+}  // namespace multivariate_detail
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER> operator+(
+        const MultivariatePolynomial<ValueType, NVARS, ORDER>& lhs,
+        const MultivariatePolynomial<ValueType, NVARS, ORDER>& rhs) {
+    return multivariate_detail::merge_terms(lhs, rhs, false);
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER> operator-(
+        const MultivariatePolynomial<ValueType, NVARS, ORDER>& lhs,
+        const MultivariatePolynomial<ValueType, NVARS, ORDER>& rhs) {
+    return multivariate_detail::merge_terms(lhs, rhs, true);
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER> operator*(
+        const MultivariatePolynomial<ValueType, NVARS, ORDER>& lhs,
+        const MultivariatePolynomial<ValueType, NVARS, ORDER>& rhs) {
+    if (lhs.Terms() == 0 || rhs.Terms() == 0) {
+        return MultivariatePolynomial<ValueType, NVARS, ORDER>(ValueType(0));
+    }
+    // the heap holds one entry per term of the first factor: take the one with fewer terms
+    if (lhs.Terms() <= rhs.Terms()) {
+        return multivariate_detail::heap_multiply(lhs, rhs);
+    } else {
+        return multivariate_detail::heap_multiply(rhs, lhs);
+    }
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER> operator*(
+        const MultivariatePolynomial<ValueType, NVARS, ORDER>& lhs, const ValueType& rhs) {
+    MultivariatePolynomial<ValueType, NVARS, ORDER> res = lhs;
+    res *= rhs;
+    return res;
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+MultivariatePolynomial<ValueType, NVARS, ORDER> operator*(
+        const ValueType& lhs, const MultivariatePolynomial<ValueType, NVARS, ORDER>& rhs) {
+    return rhs * lhs;
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+bool operator==(const MultivariatePolynomial<ValueType, NVARS, ORDER>& lhs,
+                const MultivariatePolynomial<ValueType, NVARS, ORDER>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+bool operator!=(const MultivariatePolynomial<ValueType, NVARS, ORDER>& lhs,
+                const MultivariatePolynomial<ValueType, NVARS, ORDER>& rhs) {
+    return !(lhs == rhs);
+}
+
+// prints the terms from the greatest monomial down, e.g. 3*x0^2*x1-x2+1
+template <typename ValueType, size_t NVARS, MonomialOrder ORDER>
+std::ostream& operator<<(std::ostream& out, const MultivariatePolynomial<ValueType, NVARS, ORDER>& poly) {
+    if (poly.Terms() == 0) {
+        out << ValueType(0);
+        return out;
+    }
+    for (auto it = poly.end(); it != poly.begin(); ) {
+        const auto& [monomial, coeff] = *--it;
+        const ValueType abs_coeff = (coeff > ValueType(0) ? coeff : -coeff);
+
+        if (abs_coeff == coeff) {  // +
+            if (std::next(it) != poly.end()) {
+                out << '+';
+            }
+        } else {  // -
+            out << '-';
+        }
+
+        const bool constant = (monomial.Degree() == 0);
+        if (constant || abs_coeff != ValueType(1)) {
+            out << abs_coeff;
+            if (!constant) {
+                out << '*';
+            }
+        }
+
+        bool first = true;
+        for (size_t var = 0; var < NVARS; ++var) {
+            const unsigned exp = monomial.Exponent(var);
+            if (exp == 0) {
+                continue;
+            }
+            if (!first) {
+                out << '*';
+            }
+            first = false;
+            out << 'x' << var;
+            if (exp > 1) {
+                out << '^' << exp;
+            }
+        }
+    }
+    return out;
+}
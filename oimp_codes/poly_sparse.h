@@ -1,8 +1,14 @@
 #include <algorithm>
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <queue>
+#include <utility>
 #include <vector>
 
+#include "sparse_terms.h"
+
 template <typename ValueType>
 class Polynomial {
 private:
@@ -13,6 +19,8 @@ private:
 public:
     explicit Polynomial(const std::vector<ValueType>&);
     explicit Polynomial(const ValueType& = ValueType());
+    // {degree, coeff} terms, zero coeffs are dropped
+    explicit Polynomial(std::map<size_t, ValueType> terms);
     template <typename Iter>
     Polynomial(Iter first, Iter last);
 
@@ -21,6 +29,8 @@ public:
     const ValueType& operator[](size_t index) const;
 
     ValueType operator()(const ValueType&) const;
+    // values at every point, O(#terms * log(degree)) multiplications per point
+    std::vector<ValueType> evaluate(const std::vector<ValueType>& points) const;
 
     typename std::map<size_t, ValueType>::const_iterator begin() const;
     typename std::map<size_t, ValueType>::const_iterator end() const;
@@ -51,6 +61,14 @@ Polynomial<ValueType>::Polynomial(const std::vector<ValueType>& coeffs_vec): ZER
     }
 }
 
+template<typename ValueType>
+Polynomial<ValueType>::Polynomial(std::map<size_t, ValueType> terms):
+        coeffs(std::move(terms)), ZERO(ValueType(0)) {
+    for (auto it = coeffs.begin(); it != coeffs.end(); ) {
+        it = (it->second == ZERO ? coeffs.erase(it) : std::next(it));
+    }
+}
+
 template<typename ValueType>
 template<typename Iter>
 Polynomial<ValueType>::Polynomial(Iter first, Iter last):
@@ -68,12 +86,36 @@ const ValueType& Polynomial<ValueType>::operator[](size_t index) const {
 
 template<typename ValueType>
 ValueType Polynomial<ValueType>::operator()(const ValueType& arg) const {
-    ValueType res(0);
-    ValueType cur_pow(1);
+    return sparse_terms::evaluate(coeffs.crbegin(), coeffs.crend(), arg);
+}
 
-    for (int deg = 0; deg <= this->Degree(); ++deg) {
-        res += (*this)[deg] * cur_pow;
-        cur_pow *= arg;
+template<typename ValueType>
+std::vector<ValueType> Polynomial<ValueType>::evaluate(const std::vector<ValueType>& points) const {
+    // the same walk for all the points at once: the loops over points are innermost
+    // and every gap is decomposed into bits only once
+    const size_t count = points.size();
+    std::vector<ValueType> res(count, ValueType(0)), base(count);
+    for (auto it = coeffs.rbegin(); it != coeffs.rend(); ++it) {
+        for (size_t j = 0; j < count; ++j) {
+            res[j] += it->second;
+        }
+        size_t gap = it->first - (std::next(it) != coeffs.rend() ? std::next(it)->first : 0);
+        if (gap == 0) {
+            continue;
+        }
+        std::copy(points.begin(), points.end(), base.begin());
+        for (; gap > 0; gap >>= 1) {
+            if (gap & 1) {
+                for (size_t j = 0; j < count; ++j) {
+                    res[j] *= base[j];
+                }
+            }
+            if (gap > 1) {
+                for (size_t j = 0; j < count; ++j) {
+                    base[j] *= base[j];
+                }
+            }
+        }
     }
     return res;
 }
@@ -123,14 +165,33 @@ Polynomial<ValueType>& Polynomial<ValueType>::operator*=(const ValueType& rhs) {
     return (*this = *this * rhs);
 }
 
+namespace sparse_detail {
+
+// lhs + rhs or lhs - rhs, every result term is appended at the end of the map
+template <typename ValueType>
+Polynomial<ValueType> merge_terms(const Polynomial<ValueType>& lhs,
+                                  const Polynomial<ValueType>& rhs, bool subtract) {
+    std::map<size_t, ValueType> res;
+    sparse_terms::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), subtract,
+                        [&res](size_t deg, const ValueType& coeff) { res.emplace_hint(res.end(), deg, coeff); });
+    return Polynomial<ValueType>(std::move(res));
+}
+
+// lhs * rhs, lhs should have fewer terms
+template <typename ValueType>
+Polynomial<ValueType> heap_multiply(const Polynomial<ValueType>& lhs, const Polynomial<ValueType>& rhs) {
+    std::map<size_t, ValueType> res;
+    sparse_terms::heap_multiply(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                                [&res](size_t deg, const ValueType& coeff) { res.emplace_hint(res.end(), deg, coeff); });
+    return Polynomial<ValueType>(std::move(res));
+}
+
+}  // namespace sparse_detail
+
 template<typename ValueType>
 Polynomial<ValueType> operator+(const Polynomial<ValueType>& lhs,
                                 const Polynomial<ValueType>& rhs) {
-    std::vector<ValueType> res;
-    for (int deg = 0; deg <= std::max(lhs.Degree(), rhs.Degree()); ++deg) {
-        res.push_back(lhs[deg] + rhs[deg]);
-    }
-    return Polynomial(res);
+    return sparse_detail::merge_terms(lhs, rhs, false);
 }
 
 template<typename ValueType>
@@ -146,11 +207,7 @@ Polynomial<ValueType> operator+(const ValueType& lhs, const Polynomial<ValueType
 template<typename ValueType>
 Polynomial<ValueType> operator-(const Polynomial<ValueType>& lhs,
                                 const Polynomial<ValueType>& rhs) {
-    std::vector<ValueType> res;
-    for (int deg = 0; deg <= std::max(lhs.Degree(), rhs.Degree()); ++deg) {
-        res.push_back(lhs[deg] - rhs[deg]);
-    }
-    return Polynomial(res);
+    return sparse_detail::merge_terms(lhs, rhs, true);
 }
 
 template<typename ValueType>
@@ -171,14 +228,12 @@ Polynomial<ValueType> operator*(const Polynomial<ValueType>& lhs,
         return (LDEG == -1 ? lhs : rhs);
     }
 
-    std::vector<ValueType> res(LDEG + RDEG + 1, ValueType(0));
-
-    for (int ldeg = 0; ldeg <= LDEG; ++ldeg) {
-        for (int rdeg = 0; rdeg <= RDEG; ++rdeg) {
-            res[ldeg + rdeg] += lhs[ldeg] * rhs[rdeg];
-        }
+    // the heap holds one entry per term of the first factor: take the one with fewer terms
+    if (std::distance(lhs.begin(), lhs.end()) <= std::distance(rhs.begin(), rhs.end())) {
+        return sparse_detail::heap_multiply(lhs, rhs);
+    } else {
+        return sparse_detail::heap_multiply(rhs, lhs);
     }
-    return Polynomial(res);
 }
 
 template<typename ValueType>
@@ -283,9 +338,7 @@ Polynomial<ValueType> operator&(const Polynomial<ValueType>& f, const Polynomial
 
 template <typename ValueType>
 Polynomial<ValueType> x_pow(size_t pow) {
-    std::vector<ValueType> vec(pow + 1, ValueType(0));
-    vec[pow] = ValueType(1);
-    return Polynomial(vec);
+    return Polynomial<ValueType>(std::map<size_t, ValueType>{{pow, ValueType(1)}});
 }
 
 template <typename ValueType>
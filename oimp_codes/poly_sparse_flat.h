@@ -0,0 +1,378 @@
+#pragma once
+
+//
+// Created on 19/10/2026
+//
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "sparse_terms.h"
+
+// Sparse polynomial stored as one contiguous array of {degree, coeff} terms sorted by degree:
+// iteration is a linear scan, operator[] is a binary search, copying is a single allocation.
+// Same interface as poly_sparse.h, the iterators yield {degree, coeff} pairs.
+template <typename ValueType>
+class Polynomial {
+private:
+    // {degree, coeff}, degrees strictly increase and there are no zero coeffs
+    std::vector<std::pair<size_t, ValueType>> coeffs;
+    ValueType ZERO;
+
+    // sorts the terms by degree, sums up the terms of equal degrees and drops zeros
+    void normalize();
+
+public:
+    explicit Polynomial(const std::vector<ValueType>&);
+    explicit Polynomial(const ValueType& = ValueType());
+    // {degree, coeff} terms in any order, the coeffs of equal degrees are summed up
+    explicit Polynomial(std::vector<std::pair<size_t, ValueType>> terms);
+    template <typename Iter>
+    Polynomial(Iter first, Iter last);
+
+    int Degree() const;
+    // number of nonzero terms
+    size_t Terms() const;
+
+    const ValueType& operator[](size_t index) const;
+
+    ValueType operator()(const ValueType&) const;
+
+    typename std::vector<std::pair<size_t, ValueType>>::const_iterator begin() const;
+    typename std::vector<std::pair<size_t, ValueType>>::const_iterator end() const;
+
+    Polynomial<ValueType>& operator+=(const Polynomial<ValueType>&);
+    Polynomial<ValueType>& operator+=(const ValueType&);
+
+    Polynomial<ValueType>& operator-=(const Polynomial<ValueType>&);
+    Polynomial<ValueType>& operator-=(const ValueType&);
+
+    Polynomial<ValueType>& operator*=(const Polynomial<ValueType>&);
+    Polynomial<ValueType>& operator*=(const ValueType&);
+};
+
+namespace sparse_detail {
+
+// lhs + rhs or lhs - rhs by merging the two sorted term arrays
+template <typename ValueType>
+Polynomial<ValueType> merge_terms(const Polynomial<ValueType>& lhs,
+                                  const Polynomial<ValueType>& rhs, bool subtract) {
+    std::vector<std::pair<size_t, ValueType>> res;
+    res.reserve(lhs.Terms() + rhs.Terms());
+    sparse_terms::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), subtract,
+                        [&res](size_t deg, const ValueType& coeff) { res.emplace_back(deg, coeff); });
+    return Polynomial<ValueType>(std::move(res));
+}
+
+}  // namespace sparse_detail
+
+template<typename ValueType>
+void Polynomial<ValueType>::normalize() {
+    auto by_degree = [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; };
+    if (!std::is_sorted(coeffs.begin(), coeffs.end(), by_degree)) {
+        std::stable_sort(coeffs.begin(), coeffs.end(), by_degree);
+    }
+
+    size_t size = 0;
+    for (size_t i = 0; i < coeffs.size(); ) {
+        std::pair<size_t, ValueType> term = coeffs[i];
+        for (++i; i < coeffs.size() && coeffs[i].first == term.first; ++i) {
+            term.second += coeffs[i].second;
+        }
+        if (term.second != ZERO) {
+            coeffs[size++] = term;
+        }
+    }
+    coeffs.resize(size);
+}
+
+template<typename ValueType>
+Polynomial<ValueType>::Polynomial(const ValueType& coeff): ZERO(ValueType(0)) {
+    if (coeff != ZERO) {
+        coeffs.emplace_back(0, coeff);
+    }
+}
+
+template<typename ValueType>
+Polynomial<ValueType>::Polynomial(const std::vector<ValueType>& coeffs_vec): ZERO(ValueType(0)) {
+    for (size_t deg = 0; deg < coeffs_vec.size(); ++deg) {
+        if (coeffs_vec[deg] != ZERO) {
+            coeffs.emplace_back(deg, coeffs_vec[deg]);
+        }
+    }
+}
+
+template<typename ValueType>
+Polynomial<ValueType>::Polynomial(std::vector<std::pair<size_t, ValueType>> terms):
+        coeffs(std::move(terms)), ZERO(ValueType(0)) {
+    normalize();
+}
+
+template<typename ValueType>
+template<typename Iter>
+Polynomial<ValueType>::Polynomial(Iter first, Iter last):
+                        Polynomial<ValueType>(std::vector<ValueType>(first, last)) {}
+
+template<typename ValueType>
+const ValueType& Polynomial<ValueType>::operator[](size_t index) const {
+    auto it = std::lower_bound(coeffs.begin(), coeffs.end(), index,
+                               [](const auto& term, size_t deg) { return term.first < deg; });
+    if (it == coeffs.end() || it->first != index) {
+        return ZERO;
+    } else {
+        return it->second;
+    }
+}
+
+template<typename ValueType>
+ValueType Polynomial<ValueType>::operator()(const ValueType& arg) const {
+    return sparse_terms::evaluate(coeffs.crbegin(), coeffs.crend(), arg);
+}
+
+template<typename ValueType>
+int Polynomial<ValueType>::Degree() const {
+    return (coeffs.empty() ? -1 : coeffs.back().first);
+}
+
+template<typename ValueType>
+size_t Polynomial<ValueType>::Terms() const {
+    return coeffs.size();
+}
+
+template<typename ValueType>
+typename std::vector<std::pair<size_t, ValueType>>::const_iterator Polynomial<ValueType>::begin() const {
+    return coeffs.cbegin();
+}
+
+template<typename ValueType>
+typename std::vector<std::pair<size_t, ValueType>>::const_iterator Polynomial<ValueType>::end() const {
+    return coeffs.cend();
+}
+
+template<typename ValueType>
+Polynomial<ValueType> &Polynomial<ValueType>::operator+=(const Polynomial<ValueType>& add) {
+    return (*this = *this + add);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> &Polynomial<ValueType>::operator+=(const ValueType& add) {
+    return (*this = *this + add);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> &Polynomial<ValueType>::operator-=(const Polynomial<ValueType>& add) {
+    return (*this = *this - add);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> &Polynomial<ValueType>::operator-=(const ValueType& add) {
+    return (*this = *this - add);
+}
+
+template<typename ValueType>
+Polynomial<ValueType>& Polynomial<ValueType>::operator*=(const Polynomial<ValueType>& rhs) {
+    return (*this = *this * rhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType>& Polynomial<ValueType>::operator*=(const ValueType& rhs) {
+    if (rhs == ZERO) {
+        coeffs.clear();
+        return *this;
+    }
+    for (auto& term : coeffs) {
+        term.second *= rhs;
+    }
+    normalize();  // zero divisors
+    return *this;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(const Polynomial<ValueType>& lhs,
+                                const Polynomial<ValueType>& rhs) {
+    return sparse_detail::merge_terms(lhs, rhs, false);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    return lhs + Polynomial(rhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator+(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    return rhs + lhs;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(const Polynomial<ValueType>& lhs,
+                                const Polynomial<ValueType>& rhs) {
+    return sparse_detail::merge_terms(lhs, rhs, true);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    return lhs - Polynomial(rhs);
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator-(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    return Polynomial(lhs) - rhs;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator*(const Polynomial<ValueType>& lhs,
+                                const Polynomial<ValueType>& rhs) {
+    const Polynomial<ValueType>& fewer = (lhs.Terms() <= rhs.Terms() ? lhs : rhs);
+    const Polynomial<ValueType>& more = (lhs.Terms() <= rhs.Terms() ? rhs : lhs);
+    std::vector<std::pair<size_t, ValueType>> res;
+    sparse_terms::heap_multiply(fewer.begin(), fewer.end(), more.begin(), more.end(),
+                                [&res](size_t deg, const ValueType& coeff) { res.emplace_back(deg, coeff); });
+    return Polynomial<ValueType>(std::move(res));
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator*(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    Polynomial<ValueType> res = lhs;
+    res *= rhs;
+    return res;
+}
+
+template<typename ValueType>
+Polynomial<ValueType> operator*(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    return rhs * lhs;
+}
+
+template<typename ValueType>
+bool operator==(const Polynomial<ValueType>& lhs, const Polynomial<ValueType>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template<typename ValueType>
+bool operator==(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    return (lhs.Degree() <= 0) && (lhs[0] == rhs);
+}
+
+template<typename ValueType>
+bool operator==(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    return (rhs == lhs);
+}
+
+template<typename ValueType>
+bool operator!=(const Polynomial<ValueType>& lhs, const Polynomial<ValueType>& rhs) {
+    return !(lhs == rhs);
+}
+
+template<typename ValueType>
+bool operator!=(const Polynomial<ValueType>& lhs, const ValueType& rhs) {
+    return !(lhs == rhs);
+}
+
+template<typename ValueType>
+bool operator!=(const ValueType& lhs, const Polynomial<ValueType>& rhs) {
+    return !(lhs == rhs);
+}
+
+template<typename ValueType>
+ValueType abs(const ValueType& num) {
+    if (num > ValueType(0)) {
+        return num;
+    } else {
+        return -num;
+    }
+}
+
+template<typename ValueType>
+std::ostream& operator<<(std::ostream& out, const Polynomial<ValueType>& poly) {
+    if (poly.Degree() == -1) {
+        out << ValueType(0);
+    } else {
+        for (auto it = poly.end(); it != poly.begin(); ) {
+            const auto& [deg, coeff] = *--it;
+            ValueType abs_coeff = abs(coeff);
+
+            if (abs_coeff == coeff) {  // +
+                if (static_cast<int>(deg) != poly.Degree()) {
+                    out << '+';
+                }
+            } else {  // -
+                out << '-';
+            }
+
+            if (deg == 0 || abs_coeff != ValueType(1)) {
+                out << abs_coeff;
+                if (deg != 0) {
+                    out << '*';
+                }
+            }
+
+            if (deg != 0) {
+                out << 'x';
+                if (deg > 1) {
+                    out << '^' << deg;
+                }
+            }
+        }
+    }
+    return out;
+}
+
+// returns f(g(x))
+template <typename ValueType>
+Polynomial<ValueType> operator&(const Polynomial<ValueType>& f, const Polynomial<ValueType>& g) {
+    return sparse_terms::evaluate(std::make_reverse_iterator(f.end()),
+                                  std::make_reverse_iterator(f.begin()), g);
+}
+
+template <typename ValueType>
+Polynomial<ValueType> x_pow(size_t pow) {
+    return Polynomial<ValueType>(std::vector<std::pair<size_t, ValueType>>{{pow, ValueType(1)}});
+}
+
+template <typename ValueType>
+Polynomial<ValueType> operator/(Polynomial<ValueType> dividend,
+                                const Polynomial<ValueType>& divisor) {
+    Polynomial<ValueType> res(ValueType(0));
+    if (dividend.Degree() < divisor.Degree()) {
+        return res;
+    }
+
+    for (int cur_pow = dividend.Degree() - divisor.Degree(); cur_pow >= 0; ) {
+        Polynomial<ValueType> cur_mult =
+                (dividend[dividend.Degree()] / divisor[divisor.Degree()])
+                * x_pow<ValueType>(cur_pow);
+
+        if (cur_mult == Polynomial<ValueType>(ValueType(0))) {
+            break;
+        }
+
+        dividend -= cur_mult * divisor;
+        res += cur_mult;
+
+        cur_pow = dividend.Degree() - divisor.Degree();
+    }
+
+    return res;
+}
+
+template <typename ValueType>
+Polynomial<ValueType> operator%(const Polynomial<ValueType>& dividend,
+                                const Polynomial<ValueType>& divisor) {
+    return dividend - (dividend / divisor) * divisor;
+}
+
+template <typename ValueType>
+Polynomial<ValueType> operator,(Polynomial<ValueType> a, Polynomial<ValueType> b) {
+    while (a.Degree() != -1 && b.Degree() != -1) {
+        if (a.Degree() > b.Degree() ||
+            (a.Degree() == b.Degree() && a[a.Degree()] > b[b.Degree()])) {
+            a = a % b;
+        } else {
+            b = b % a;
+        }
+    }
+    Polynomial<ValueType> res = a + b;
+    return res / Polynomial(res[res.Degree()]);
+}
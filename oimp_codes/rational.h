@@ -1,3 +1,6 @@
+#pragma once
+
+#include <cassert>
 #include <cstdlib>
 
 class Rational {
@@ -9,11 +12,13 @@ private:
 
 public:
     Rational();
-    Rational(int, int);
+    Rational(int, int = 1);
 
     int numerator() const;
     int denominator() const;
 
+    double to_double() const;
+
     Rational operator+() const;
     Rational operator-() const;
 
@@ -36,7 +41,7 @@ public:
     Rational operator--(int);
 };
 
-int calc_gcd(int a, int b) {
+inline int calc_gcd(int a, int b) {
     while (a && b) {
         if (a > b) {
             a %= b;
@@ -47,13 +52,14 @@ int calc_gcd(int a, int b) {
     return a + b;
 }
 
-int calc_lcm(int a, int b) {
+inline int calc_lcm(int a, int b) {
     return a*b / calc_gcd(a, b);
 }
 
-Rational::Rational(): num(0), denom(1) {}
+inline Rational::Rational(): num(0), denom(1) {}
 
-Rational::Rational(int _num, int _denom) {
+inline Rational::Rational(int _num, int _denom) {
+    assert(_denom != 0);
     if (_denom < 0) {
         _num = -_num;
         _denom = -_denom;
@@ -63,140 +69,169 @@ Rational::Rational(int _num, int _denom) {
     reduct();
 }
 
-void Rational::reduct() {
+inline void Rational::reduct() {
     int gcd = calc_gcd(std::abs(num), denom);
     num /= gcd;
     denom /= gcd;
 }
 
-int Rational::numerator() const {
+inline int Rational::numerator() const {
     return num;
 }
 
-int Rational::denominator() const {
+inline int Rational::denominator() const {
     return denom;
 }
 
-Rational Rational::operator-() const {
+inline double Rational::to_double() const {
+    return static_cast<double>(num) / denom;
+}
+
+inline Rational Rational::operator-() const {
     return {-num, denom};
 }
 
-Rational Rational::operator+() const {
+inline Rational Rational::operator+() const {
     return *this;
 }
 
-Rational operator+(const Rational& a, const Rational& b) {
+inline Rational operator+(const Rational& a, const Rational& b) {
     int common_denom = calc_lcm(a.denominator(), b.denominator());
     int new_num = common_denom / a.denominator() * a.numerator() +
                   common_denom / b.denominator() * b.numerator();
     return {new_num, common_denom};
 }
 
-Rational operator+(const Rational& a, int b) {
+inline Rational operator+(const Rational& a, int b) {
     return {a.numerator() + b * a.denominator(),
             a.denominator()};
 }
 
-Rational operator+(int a, const Rational& b) {
+inline Rational operator+(int a, const Rational& b) {
     return b + a;
 }
 
-Rational operator-(const Rational& a, const Rational& b) {
+inline Rational operator-(const Rational& a, const Rational& b) {
     return a + (-b);
 }
 
-Rational operator-(const Rational& a, int b) {
+inline Rational operator-(const Rational& a, int b) {
     return a + (-b);
 }
 
-Rational operator-(int a, const Rational& b) {
+inline Rational operator-(int a, const Rational& b) {
     return a + (-b);
 }
 
-Rational operator*(const Rational& a, int b) {
+inline Rational operator*(const Rational& a, int b) {
     return {a.numerator() * b, a.denominator()};
 }
 
-Rational operator*(int a, const Rational& b) {
+inline Rational operator*(int a, const Rational& b) {
     return b * a;
 }
 
-Rational operator*(const Rational& a, const Rational& b) {
+inline Rational operator*(const Rational& a, const Rational& b) {
     return {a.numerator() * b.numerator(),
             a.denominator() * b.denominator()};
 }
 
-Rational operator/(const Rational& a, int b) {
+inline Rational operator/(const Rational& a, int b) {
     return {a.numerator(), a.denominator() * b};
 }
 
-Rational operator/(int a, const Rational& b) {
+inline Rational operator/(int a, const Rational& b) {
     return a * Rational(b.denominator(), b.numerator());
 }
 
-Rational operator/(const Rational& a, const Rational& b) {
+inline Rational operator/(const Rational& a, const Rational& b) {
     return a * Rational(b.denominator(), b.numerator());
 }
 
-Rational& Rational::operator+=(const Rational& a) {
+inline Rational& Rational::operator+=(const Rational& a) {
     return (*this = *this + a);
 }
 
-Rational& Rational::operator+=(int a) {
+inline Rational& Rational::operator+=(int a) {
     return (*this = *this + a);
 }
 
-Rational& Rational::operator-=(const Rational& a) {
+inline Rational& Rational::operator-=(const Rational& a) {
     return (*this = *this - a);
 }
 
-Rational& Rational::operator-=(int a) {
+inline Rational& Rational::operator-=(int a) {
     return (*this = *this - a);
 }
 
-Rational& Rational::operator*=(const Rational& a) {
+inline Rational& Rational::operator*=(const Rational& a) {
     return (*this = *this * a);
 }
 
-Rational& Rational::operator*=(int a) {
+inline Rational& Rational::operator*=(int a) {
     return (*this = *this * a);
 }
 
-Rational& Rational::operator/=(const Rational& a) {
+inline Rational& Rational::operator/=(const Rational& a) {
     return (*this = *this / a);
 }
 
-Rational& Rational::operator/=(int a) {
+inline Rational& Rational::operator/=(int a) {
     return (*this = *this / a);
 }
 
-Rational& Rational::operator++() {
+inline Rational& Rational::operator++() {
     *this += 1;
     return *this;
 }
 
-Rational& Rational::operator--() {
+inline Rational& Rational::operator--() {
     *this -= 1;
     return *this;
 }
 
-Rational Rational::operator++(int) {
+inline Rational Rational::operator++(int) {
     Rational temp(*this);
     ++(*this);
     return temp;
 }
 
-Rational Rational::operator--(int) {
+inline Rational Rational::operator--(int) {
     Rational temp(*this);
     --(*this);
     return temp;
 }
 
-bool operator==(const Rational& a, const Rational& b) {
+inline bool operator==(const Rational& a, const Rational& b) {
     return a.numerator() == b.numerator() && a.denominator() == b.denominator();
 }
 
-bool operator!=(const Rational& a, const Rational& b) {
+inline bool operator!=(const Rational& a, const Rational& b) {
     return !(a == b);
 }
 
+
+// returns negative num if (a < b), null if (a == b), positive num if (a > b)
+// denominators are positive, so the signs of the cross products decide;
+// int * int always fits in long long, so the comparison never overflows
+inline int compare(const Rational& a, const Rational& b) {
+    long long lhs = 1LL * a.numerator() * b.denominator();
+    long long rhs = 1LL * b.numerator() * a.denominator();
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+inline bool operator<(const Rational& a, const Rational& b) {
+    return compare(a, b) < 0;
+}
+
+inline bool operator<=(const Rational& a, const Rational& b) {
+    return compare(a, b) <= 0;
+}
+
+inline bool operator>(const Rational& a, const Rational& b) {
+    return compare(a, b) > 0;
+}
+
+inline bool operator>=(const Rational& a, const Rational& b) {
+    return compare(a, b) >= 0;
+}
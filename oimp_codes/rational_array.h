@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+#include "rational.h"
+
+// Structure-of-arrays storage for many independent rationals:
+// numerators and denominators live in two separate contiguous arrays,
+// so the batch kernels below run over plain int arrays and can be auto-vectorized.
+// Every element is kept in the same canonical form as Rational (reduced, denominator > 0).
+class RationalArray {
+private:
+    std::vector<int> nums;
+    std::vector<int> denoms;
+
+public:
+    RationalArray() = default;
+    explicit RationalArray(size_t size);
+    explicit RationalArray(const std::vector<Rational>&);
+    // numerators and denominators of the same size, not necessarily reduced
+    RationalArray(const std::vector<int>& nums, const std::vector<int>& denoms);
+
+    size_t size() const;
+    bool empty() const;
+
+    Rational operator[](size_t index) const;
+    void set(size_t index, const Rational&);
+    void push_back(const Rational&);
+
+    const int* numerators() const;
+    const int* denominators() const;
+
+    // brings every element to the canonical form
+    // (needed only after the raw arrays were filled in the constructor)
+    void normalize();
+
+    RationalArray& operator+=(const RationalArray&);
+    RationalArray& operator-=(const RationalArray&);
+    RationalArray& operator*=(const RationalArray&);
+    RationalArray& operator/=(const RationalArray&);
+};
+
+//
+// batch kernels:
+// each one works on n elements of raw arrays, output arrays may coincide with input ones
+//
+
+// binary (Stein's) gcd, no divisions
+inline unsigned long long binary_gcd(unsigned long long a, unsigned long long b) {
+    if (a == 0 || b == 0) {
+        return a | b;
+    }
+    int shift = __builtin_ctzll(a | b);
+    a >>= __builtin_ctzll(a);
+    while (b != 0) {
+        b >>= __builtin_ctzll(b);
+        unsigned long long diff = (a > b ? a - b : b - a);
+        a = (a < b ? a : b);
+        b = diff;
+    }
+    return a << shift;
+}
+
+// reduces num[i] / denom[i] computed with 64-bit intermediates
+// and writes the canonical form to res_num, res_denom; every denom[i] must be nonzero
+inline void normalize_rationals(const long long* num, const long long* denom,
+                         int* res_num, int* res_denom, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        assert(denom[i] != 0);
+        long long sign = (denom[i] < 0 ? -1 : 1);
+        unsigned long long abs_num = std::llabs(num[i]);
+        unsigned long long abs_denom = std::llabs(denom[i]);
+        unsigned long long gcd = binary_gcd(abs_num, abs_denom);
+        if (gcd == 0) {
+            gcd = 1;
+        }
+        res_num[i] = static_cast<int>(sign * num[i] / static_cast<long long>(gcd));
+        res_denom[i] = static_cast<int>(abs_denom / gcd);
+    }
+}
+
+// the elementwise loops below contain no branches and no divisions
+// and widen int to long long, so they compile into SIMD multiplies;
+// they run in blocks of RATIONAL_BLOCK elements with the 64-bit intermediates on the stack
+const size_t RATIONAL_BLOCK = 256;
+
+inline void add_rationals(const int* lnum, const int* ldenom, const int* rnum, const int* rdenom,
+                          int* res_num, int* res_denom, size_t n) {
+    long long num[RATIONAL_BLOCK], denom[RATIONAL_BLOCK];
+    for (size_t first = 0; first < n; first += RATIONAL_BLOCK) {
+        const size_t count = std::min(RATIONAL_BLOCK, n - first);
+        for (size_t i = 0, j = first; i < count; ++i, ++j) {
+            num[i] = 1LL * lnum[j] * rdenom[j] + 1LL * rnum[j] * ldenom[j];
+            denom[i] = 1LL * ldenom[j] * rdenom[j];
+        }
+        normalize_rationals(num, denom, res_num + first, res_denom + first, count);
+    }
+}
+
+inline void sub_rationals(const int* lnum, const int* ldenom, const int* rnum, const int* rdenom,
+                          int* res_num, int* res_denom, size_t n) {
+    long long num[RATIONAL_BLOCK], denom[RATIONAL_BLOCK];
+    for (size_t first = 0; first < n; first += RATIONAL_BLOCK) {
+        const size_t count = std::min(RATIONAL_BLOCK, n - first);
+        for (size_t i = 0, j = first; i < count; ++i, ++j) {
+            num[i] = 1LL * lnum[j] * rdenom[j] - 1LL * rnum[j] * ldenom[j];
+            denom[i] = 1LL * ldenom[j] * rdenom[j];
+        }
+        normalize_rationals(num, denom, res_num + first, res_denom + first, count);
+    }
+}
+
+inline void mul_rationals(const int* lnum, const int* ldenom, const int* rnum, const int* rdenom,
+                          int* res_num, int* res_denom, size_t n) {
+    long long num[RATIONAL_BLOCK], denom[RATIONAL_BLOCK];
+    for (size_t first = 0; first < n; first += RATIONAL_BLOCK) {
+        const size_t count = std::min(RATIONAL_BLOCK, n - first);
+        for (size_t i = 0, j = first; i < count; ++i, ++j) {
+            num[i] = 1LL * lnum[j] * rnum[j];
+            denom[i] = 1LL * ldenom[j] * rdenom[j];
+        }
+        normalize_rationals(num, denom, res_num + first, res_denom + first, count);
+    }
+}
+
+inline void div_rationals(const int* lnum, const int* ldenom, const int* rnum, const int* rdenom,
+                          int* res_num, int* res_denom, size_t n) {
+    long long num[RATIONAL_BLOCK], denom[RATIONAL_BLOCK];
+    for (size_t first = 0; first < n; first += RATIONAL_BLOCK) {
+        const size_t count = std::min(RATIONAL_BLOCK, n - first);
+        for (size_t i = 0, j = first; i < count; ++i, ++j) {
+            num[i] = 1LL * lnum[j] * rdenom[j];
+            denom[i] = 1LL * ldenom[j] * rnum[j];
+        }
+        normalize_rationals(num, denom, res_num + first, res_denom + first, count);
+    }
+}
+
+//
+// implementation:
+//
+
+inline RationalArray::RationalArray(size_t size): nums(size, 0), denoms(size, 1) {}
+
+inline RationalArray::RationalArray(const std::vector<Rational>& values) {
+    nums.reserve(values.size());
+    denoms.reserve(values.size());
+    for (const auto& value : values) {
+        push_back(value);
+    }
+}
+
+inline RationalArray::RationalArray(const std::vector<int>& _nums, const std::vector<int>& _denoms):
+        nums(_nums), denoms(_denoms) {
+    assert(nums.size() == denoms.size());
+    normalize();
+}
+
+inline size_t RationalArray::size() const {
+    return nums.size();
+}
+
+inline bool RationalArray::empty() const {
+    return nums.empty();
+}
+
+inline Rational RationalArray::operator[](size_t index) const {
+    return {nums[index], denoms[index]};
+}
+
+inline void RationalArray::set(size_t index, const Rational& value) {
+    nums[index] = value.numerator();
+    denoms[index] = value.denominator();
+}
+
+inline void RationalArray::push_back(const Rational& value) {
+    nums.push_back(value.numerator());
+    denoms.push_back(value.denominator());
+}
+
+inline const int* RationalArray::numerators() const {
+    return nums.data();
+}
+
+inline const int* RationalArray::denominators() const {
+    return denoms.data();
+}
+
+inline void RationalArray::normalize() {
+    long long num[RATIONAL_BLOCK], denom[RATIONAL_BLOCK];
+    for (size_t first = 0; first < size(); first += RATIONAL_BLOCK) {
+        const size_t count = std::min(RATIONAL_BLOCK, size() - first);
+        std::copy(nums.begin() + first, nums.begin() + first + count, num);
+        std::copy(denoms.begin() + first, denoms.begin() + first + count, denom);
+        normalize_rationals(num, denom, nums.data() + first, denoms.data() + first, count);
+    }
+}
+
+inline RationalArray& RationalArray::operator+=(const RationalArray& other) {
+    assert(size() == other.size());
+    add_rationals(nums.data(), denoms.data(), other.nums.data(), other.denoms.data(),
+                  nums.data(), denoms.data(), size());
+    return *this;
+}
+
+inline RationalArray& RationalArray::operator-=(const RationalArray& other) {
+    assert(size() == other.size());
+    sub_rationals(nums.data(), denoms.data(), other.nums.data(), other.denoms.data(),
+                  nums.data(), denoms.data(), size());
+    return *this;
+}
+
+inline RationalArray& RationalArray::operator*=(const RationalArray& other) {
+    assert(size() == other.size());
+    mul_rationals(nums.data(), denoms.data(), other.nums.data(), other.denoms.data(),
+                  nums.data(), denoms.data(), size());
+    return *this;
+}
+
+inline RationalArray& RationalArray::operator/=(const RationalArray& other) {
+    assert(size() == other.size());
+    div_rationals(nums.data(), denoms.data(), other.nums.data(), other.denoms.data(),
+                  nums.data(), denoms.data(), size());
+    return *this;
+}
+
+inline RationalArray operator+(const RationalArray& a, const RationalArray& b) {
+    RationalArray res(a);
+    return (res += b);
+}
+
+inline RationalArray operator-(const RationalArray& a, const RationalArray& b) {
+    RationalArray res(a);
+    return (res -= b);
+}
+
+inline RationalArray operator*(const RationalArray& a, const RationalArray& b) {
+    RationalArray res(a);
+    return (res *= b);
+}
+
+inline RationalArray operator/(const RationalArray& a, const RationalArray& b) {
+    RationalArray res(a);
+    return (res /= b);
+}
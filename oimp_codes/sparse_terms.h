@@ -0,0 +1,138 @@
+#pragma once
+
+//
+// Created on 19/10/2026
+//
+
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Kernels over sequences of nonzero {key, coeff} terms sorted by key, shared by the sparse
+// polynomials (poly_sparse.h, poly_sparse_flat.h and the sparse form of poly_adaptive.h,
+// where keys are degrees, and poly_multivariate.h, where keys are monomials).
+// Terms are read through iterators over pairs, results are passed to emit(key, coeff)
+// in increasing order of keys, so every storage appends them at its end.
+namespace sparse_terms {
+
+// base^exp by repeated squaring
+template <typename ValueType>
+ValueType power(ValueType base, size_t exp);
+
+// lhs + rhs or lhs - rhs by merging the two sequences, zero sums are dropped
+template <typename LhsIter, typename RhsIter, typename Emit>
+void merge(LhsIter lfirst, LhsIter llast, RhsIter rfirst, RhsIter rlast, bool subtract, Emit emit);
+
+// lhs * rhs by the Monagan-Pearce heap method: the rows lhs_i * rhs are merged
+// through a heap holding the next term of every row, so the products come out
+// in the order of keys and the equal ones are summed right away;
+// O(#lhs * #rhs * log #lhs) time and O(#lhs) extra memory whatever the keys,
+// hence lhs should be the factor with fewer terms.
+// combine(lkey, rkey) is the key of a product (the sum of degrees, the product of monomials)
+// and must keep the order: lkey < lkey' implies combine(lkey, rkey) < combine(lkey', rkey)
+template <typename LhsIter, typename RhsIter, typename Emit, typename Combine = std::plus<>>
+void heap_multiply(LhsIter lfirst, LhsIter llast, RhsIter rfirst, RhsIter rlast, Emit emit,
+                   Combine combine = Combine());
+
+// the value at arg of the terms given from the highest degree down:
+// Horner's rule over the stored terms only, arg^gap between neighbours by repeated squaring,
+// O(#terms * log(degree)) multiplications; arg may be a polynomial as well (composition)
+template <typename Arg, typename ReverseIter>
+Arg evaluate(ReverseIter first, ReverseIter last, const Arg& arg);
+
+//
+// implementation:
+//
+
+template <typename ValueType>
+ValueType power(ValueType base, size_t exp) {
+    ValueType res(1);
+    for (; exp; exp >>= 1) {
+        if (exp & 1) {
+            res *= base;
+        }
+        if (exp > 1) {
+            base *= base;
+        }
+    }
+    return res;
+}
+
+template <typename LhsIter, typename RhsIter, typename Emit>
+void merge(LhsIter lfirst, LhsIter llast, RhsIter rfirst, RhsIter rlast, bool subtract, Emit emit) {
+    while (lfirst != llast || rfirst != rlast) {
+        if (rfirst == rlast || (lfirst != llast && (*lfirst).first < (*rfirst).first)) {
+            const auto [key, coeff] = *lfirst++;
+            emit(key, coeff);
+            continue;
+        }
+        const auto [key, coeff] = *rfirst++;
+        if (lfirst == llast || key < (*lfirst).first) {
+            emit(key, subtract ? -coeff : coeff);
+        } else {
+            const auto sum = (subtract ? (*lfirst).second - coeff : (*lfirst).second + coeff);
+            if (sum != decltype(sum)(0)) {
+                emit(key, sum);
+            }
+            ++lfirst;
+        }
+    }
+}
+
+template <typename LhsIter, typename RhsIter, typename Emit, typename Combine>
+void heap_multiply(LhsIter lfirst, LhsIter llast, RhsIter rfirst, RhsIter rlast, Emit emit,
+                   Combine combine) {
+    using Key = std::decay_t<decltype(combine((*lfirst).first, (*rfirst).first))>;
+    using ValueType = decltype((*lfirst).second * (*rfirst).second);
+    if (rfirst == rlast) {
+        return;
+    }
+
+    // the row's term of lhs and the position of its next product in rhs
+    std::vector<std::pair<Key, ValueType>> rows;
+    std::vector<RhsIter> cols;
+    // {key of the next product of the row, row}
+    std::priority_queue<std::pair<Key, size_t>, std::vector<std::pair<Key, size_t>>,
+                        std::greater<>> heap;
+    for (; lfirst != llast; ++lfirst) {
+        const auto [key, coeff] = *lfirst;
+        heap.emplace(combine(key, (*rfirst).first), rows.size());
+        rows.emplace_back(key, coeff);
+        cols.push_back(rfirst);
+    }
+
+    while (!heap.empty()) {
+        const Key key = heap.top().first;
+        ValueType sum(0);
+        while (!heap.empty() && heap.top().first == key) {
+            const size_t row = heap.top().second;
+            heap.pop();
+            sum += rows[row].second * (*cols[row]).second;
+            if (++cols[row] != rlast) {
+                heap.emplace(combine(rows[row].first, (*cols[row]).first), row);
+            }
+        }
+        if (sum != ValueType(0)) {
+            emit(key, sum);
+        }
+    }
+}
+
+template <typename Arg, typename ReverseIter>
+Arg evaluate(ReverseIter first, ReverseIter last, const Arg& arg) {
+    Arg res(0);
+    while (first != last) {
+        const auto [deg, coeff] = *first++;
+        res += coeff;
+        const size_t gap = deg - (first != last ? (*first).first : 0);
+        if (gap > 0) {
+            res *= power(arg, gap);
+        }
+    }
+    return res;
+}
+
+}  // namespace sparse_terms